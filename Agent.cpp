@@ -0,0 +1,347 @@
+#include "Agent.h"
+#include "OpeningBook.h"
+#include "Solver.h"
+#include "Stats.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+random_device rd;
+mt19937 gen(rd());
+
+// Cria um agente com genoma aleatório (para o início da evolução)
+Agent::Agent() {
+    uniform_real_distribution<double> d(-10.0, 10.0);
+    genome = { d(gen), d(gen), d(gen), d(gen) };
+    fitness = 0;
+    updateWeights();
+    clearOrdering();
+}
+
+// Pré-multiplica os genes pelas constantes de cada padrão
+void Agent::updateWeights() {
+    weights[0] = genome[0] * 10.0;  // Controle de centro (por pedra)
+    weights[1] = 1000000;           // 4 alinhadas: prioriza a vitória sempre que possível
+    weights[2] = genome[2] * 50.0;  // Favorece conectar 3 pedras
+    weights[3] = genome[1] * 5.0;   // Favorece (menos) conectar 2 pedras
+    weights[4] = genome[3] * 100.0; // Tenta evitar que o oponente conecte 3 pedras
+}
+
+void Agent::clearOrdering() {
+    memset(killers, -1, sizeof(killers));
+    memset(history, 0, sizeof(history));
+}
+
+// Jogada que causou poda: vira killer deste ply e ganha pontos no histórico
+// (depth² favorece podas perto da raiz, que economizam mais nós)
+template<class B> void Agent::recordCutoff(const B& b, int col, int side, int ply, int depth) {
+    if (killers[ply][0] != col) { killers[ply][1] = killers[ply][0]; killers[ply][0] = (int8_t)col; }
+    int& h = history[side][col * B::HEIGHT + b.height[col]];
+    h += depth * depth;
+    // Envelhece a tabela antes de estourar (treinos longos reaproveitam o mesmo agente)
+    if (h >= 1 << 24) for (auto& row : history) for (int& v : row) v >>= 1;
+}
+
+// Percorre todo o tabuleiro somando os pontos de cada jogada
+template<class B> double Agent::scoreBoardScan(const B& b, int piece) const {
+    const int K = B::CONNECT;
+    double score = 0;
+    uint64_t own = b.pieces[piece - 1], opp = b.pieces[2 - piece];
+    // 1. Controle de Centro - Peças no meio valem mais
+    for (int k = PopCount(own & ColumnMaskT<B::ROWS>(B::COLS / 2)); k > 0; k--) score += genome[0] * 10.0;
+
+    // 2. Scan de Janelas (Horizontal, Vertical, Diagonais)
+    // Isso passa "janelas deslizantes" de K espaços pelo tabuleiro inteiro
+    for (int w = 0; w < B::NUM_WINDOWS; w++) {
+        int cp = PopCount(own & B::WINDOWS.mask[w]);
+        int co = PopCount(opp & B::WINDOWS.mask[w]);
+        score += evalWindow<K>(cp, K - cp - co, co);
+    }
+    return score;
+}
+
+// As janelas da casa nova entram em live e em grown (com uma pedra a mais de mover): o
+// tabuleiro não muda, e a soma é a do scoreBoard depois do drop
+template<class B> double Agent::leafScore(const B& b, int col, int mover, int piece) const {
+    const int own = piece - 1;
+    int bit = col * B::HEIGHT + b.height[col];
+    uint64_t live[B::WINDOW_WORDS], grown[B::WINDOW_WORDS] = {};
+    for (int i = 0; i < B::CELL_WINDOWS.count[bit]; i++) {
+        int w = B::CELL_WINDOWS.list[bit][i];
+        grown[w >> 6] |= 1ULL << (w & 63);
+    }
+    for (int i = 0; i < B::WINDOW_WORDS; i++) live[i] = b.scoring[0][i] | b.scoring[1][i] | grown[i];
+    int c = PopCount((b.pieces[own] | (mover == piece ? 1ULL << bit : 0)) & ColumnMaskT<B::ROWS>(B::COLS / 2));
+    return sumWindows(b, piece, c, live, grown, mover - 1);
+}
+
+// Chamado a cada 1024 nós: publica o contador de nós e verifica tempo e cancelamento
+void Agent::pollSearch() {
+    if (liveNodes) liveNodes->store(nodes, memory_order_relaxed);
+    if (cancelFlag && cancelFlag->load(memory_order_relaxed)) stopSearch = true;
+    if (useDeadline && chrono::steady_clock::now() >= deadline) stopSearch = true;
+}
+
+// Profundidade restante mínima para a janela nula do PVS. Perto das folhas a avaliação
+// heurística quase nunca repete valores, a janela nula falha muito e a nova busca sai mais
+// cara que a economia (na profundidade 4 do treino, o PVS em todos os nós visitava ~50% a mais).
+const int PVS_MIN_DEPTH = 5;
+
+// ALGORITMO MINIMAX
+template<class B>
+pair<int, double> Agent::minimax(B& b, int depth, double alpha, double beta, bool maximizing, int piece) {
+    // Checa o relógio a cada 1024 nós; se o tempo acabou, desfaz a busca sem gravar nada
+    nodes++;
+    STAT_INC(STAT_NODES);
+    if ((nodes & 1023) == 0) pollSearch();
+    if (stopSearch) return { -1, 0 };
+
+    // Verifica condições de fim de jogo
+    bool term = b.checkWin(1) || b.checkWin(2) || b.isFull();
+    int opp = (piece == 1) ? 2 : 1;
+
+    if (depth == 0 || term) {
+        if (term) {
+            // Prioriza vitória mais rápida e evita derrota imediata 
+            if (b.checkWin(piece)) return { -1, 100000000.0 + depth * 1000 };
+            else if (b.checkWin(opp)) return { -1, -100000000.0 - depth * 1000 };
+            else return { -1, 0 }; // Empate
+        }
+        // Se não acabou, retorna o mapa de pontuação
+        STAT_INC(STAT_LEAF_EVALS);
+        return { -1, scoreBoard(b, piece) };
+    }
+
+    typename B::Moves moves;
+    b.getOptimizedMoves(moves); // Pega movimentos ordenados (Centro -> Bordas)
+
+    // Consulta a Tabela de Transposição (exceto na raiz, onde a coluna escolhida importa).
+    // Só reaproveita o score se a profundidade for a mesma, porque os scores de vitória
+    // dependem da profundidade restante; a melhor coluna serve de ordenação em qualquer caso.
+    // Uma posição e o seu espelho têm o mesmo valor: a entrada fica na chave menor das duas,
+    // com a coluna na orientação dessa chave.
+    uint64_t key = 0;
+    int ttMove = -1;
+    bool flip = false;
+    if (tt) {
+        flip = B::SYMMETRIC && b.mirrorHash < b.hash;
+        key = (flip ? b.mirrorHash : b.hash) ^ ZOBRIST.side[piece - 1][maximizing];
+        TTEntry e;
+        if (searchPly > 0 && tt->probe(key, e)) {
+            STAT_INC(STAT_TT_HITS);
+            int col = flip && e.col >= 0 ? B::COLS - 1 - e.col : e.col;
+            if (e.depth == depth && (e.bound == BOUND_EXACT || (e.bound == BOUND_LOWER && e.score >= beta) ||
+                                     (e.bound == BOUND_UPPER && e.score <= alpha))) {
+                STAT_INC(STAT_TT_CUTOFFS);
+                return { col, e.score };
+            }
+            ttMove = col;
+        }
+    }
+    // Na raiz, começa pela melhor jogada da iteração anterior. Essa ordem (e não a dinâmica)
+    // decide os empates na raiz, para a coluna escolhida não depender de killers e histórico.
+    bool root = searchPly == 0;
+    int pref[B::COLS];
+    if (root) {
+        if (rootFirstMove >= 0) moves.moveToFront(rootFirstMove);
+        for (int i = 0; i < moves.size; i++) pref[moves[i]] = i;
+    }
+    double alphaOrig = alpha, betaOrig = beta;
+
+    // Antes de simular recursivamente, verifica se consegue ganhar
+    // Se houver vitória imediata, ignora o centro e joga na vitória
+    // (basta testar as pedras de quem joga com a casa nova ligada, sem mexer no tabuleiro)
+    if (maximizing) {
+        for (int col : moves) {
+            if (B::hasAlignment(b.pieces[piece - 1] | 1ULL << (col * B::HEIGHT + b.height[col]))) {
+                STAT_INC(STAT_IMMEDIATE_WINS);
+                return { col, 100000000.0 + depth * 1000 };
+            }
+        }
+    }
+    else {
+        // Se o oponente puder ganhar agora, bloqueie imediatamente
+        for (int col : moves) {
+            if (B::hasAlignment(b.pieces[opp - 1] | 1ULL << (col * B::HEIGHT + b.height[col]))) {
+                STAT_INC(STAT_IMMEDIATE_WINS);
+                return { col, -100000000.0 - depth * 1000 };
+            }
+        }
+    }
+
+    // Posição simétrica: a coluna c e a C-1-c levam a posições espelhadas, de mesmo valor, então
+    // só as colunas da metade esquerda (e a do meio) são buscadas. Na raiz a preferência
+    // Centro -> Bordas já escolhe a da esquerda num empate, então a coluna escolhida não muda.
+    if (B::SYMMETRIC && b.isSymmetric()) {
+        STAT_INC(STAT_SYMMETRIC_NODES);
+        int n = 0;
+        for (int col : moves) if (col <= B::COLS / 2) moves.col[n++] = col;
+        moves.size = n;
+    }
+
+    // Ordenação dinâmica: coluna da TT, killers deste ply, depois histórico.
+    // Inserção estável: em empate (histórico zerado) fica a ordem Centro -> Bordas.
+    int side = (maximizing ? piece : opp) - 1;
+    int ply = min(searchPly, MAX_PLY - 1);
+    int order[B::COLS];
+    for (int i = 0; i < moves.size; i++) {
+        int c = moves[i];
+        int s = c == ttMove ? 1 << 30 : c == killers[ply][0] ? 1 << 29 : c == killers[ply][1] ? 1 << 28
+              : history[side][c * B::HEIGHT + b.height[c]];
+        int j = i;
+        for (; j > 0 && order[j - 1] < s; j--) { order[j] = order[j - 1]; moves.col[j] = moves.col[j - 1]; }
+        order[j] = s; moves.col[j] = c;
+    }
+
+    // Folhas em lote (batchLeaves): cada filho conta como um nó visitado, como na recursão
+    bool batch = batchLeaves && depth == 1;
+    bool leavesFill = batch && b.moveCount() + 1 == B::ROWS * B::COLS; // Filhos enchem o tabuleiro: empate
+    auto visitLeaf = [&](int col) {
+        nodes++;
+        STAT_INC(STAT_NODES);
+        if ((nodes & 1023) == 0) pollSearch();
+        if (stopSearch || leavesFill) return 0.0;
+        STAT_INC(STAT_LEAF_EVALS);
+        return leafScore(b, col, maximizing ? piece : opp, piece);
+    };
+
+    int bestCol = moves.empty() ? -1 : moves[0];
+    double bestEval;
+    bool first = true;
+    searchPly++;
+    if (maximizing) { // Vez da AG
+        double maxEval = -numeric_limits<double>::infinity();
+        for (int col : moves) {
+            // Na raiz, uma coluna preferida que empate com a melhor também precisa vencer,
+            // então a janela começa logo abaixo de alpha
+            double lo = (root && pref[col] < pref[bestCol]) ? nextafter(alpha, -numeric_limits<double>::infinity()) : alpha;
+            double eval;
+            if (batch) eval = visitLeaf(col);
+            else {
+                b.drop(col, piece); // Simula jogada
+                if (first || depth < PVS_MIN_DEPTH) eval = minimax(b, depth - 1, lo, beta, false, piece).second; // Recursão
+                else {
+                    // Janela nula logo acima de lo; se a jogada for melhor, busca de novo com a janela inteira
+                    eval = minimax(b, depth - 1, lo, nextafter(lo, numeric_limits<double>::infinity()), false, piece).second;
+                    if (eval > lo && eval < beta && !stopSearch) eval = minimax(b, depth - 1, lo, beta, false, piece).second;
+                }
+                b.undoMove(col);
+            }
+            if (stopSearch) break;
+            first = false;
+
+            if (eval > maxEval || (root && eval == maxEval && pref[col] < pref[bestCol])) { maxEval = eval; bestCol = col; }
+            alpha = max(alpha, eval);
+            if (beta <= alpha) { cutoffs++; STAT_INC(STAT_CUTOFFS); recordCutoff(b, col, side, ply, depth); break; } // PODA ALPHA-BETA: Corta o loop se achar caminho melhor
+        }
+        bestEval = maxEval;
+    }
+    else { // Vez do Oponente (tenta minimizar o score da AG)
+        double minEval = numeric_limits<double>::infinity();
+        for (int col : moves) {
+            double eval;
+            if (batch) eval = visitLeaf(col);
+            else {
+                b.drop(col, opp);   // Simula jogada
+                if (first || depth < PVS_MIN_DEPTH) eval = minimax(b, depth - 1, alpha, beta, true, piece).second; // Recurso
+                else {
+                    // Janela nula logo abaixo de beta; se a jogada for melhor para o oponente, busca de novo
+                    double lo = nextafter(beta, -numeric_limits<double>::infinity());
+                    eval = minimax(b, depth - 1, lo, beta, true, piece).second;
+                    if (eval < beta && eval > alpha && !stopSearch) eval = minimax(b, depth - 1, alpha, beta, true, piece).second;
+                }
+                b.undoMove(col);
+            }
+            if (stopSearch) break;
+            first = false;
+
+            if (eval < minEval) { minEval = eval; bestCol = col; }
+            beta = min(beta, eval);
+            if (beta <= alpha) { cutoffs++; STAT_INC(STAT_CUTOFFS); recordCutoff(b, col, side, ply, depth); break; } // PODA
+        }
+        bestEval = minEval;
+    }
+    searchPly--;
+    if (stopSearch) return { -1, 0 };
+
+    // Grava o resultado indicando se é exato ou apenas um limite (por causa da poda)
+    if (tt) {
+        BoundType bound = BOUND_EXACT;
+        if (bestEval <= alphaOrig) bound = BOUND_UPPER;
+        else if (bestEval >= betaOrig) bound = BOUND_LOWER;
+        tt->store(key, depth, bound, bestEval, flip && bestCol >= 0 ? B::COLS - 1 - bestCol : bestCol);
+    }
+    return { bestCol, bestEval };
+}
+
+// APROFUNDAMENTO ITERATIVO COM ORÇAMENTO DE TEMPO
+template<class B>
+Agent::SearchResult Agent::think(B& b, int piece, int timeMs, int maxDepth) {
+    auto start = chrono::steady_clock::now();
+    int empty = B::ROWS * B::COLS - b.moveCount();
+    // O livro e o Solver conhecem só o tabuleiro padrão
+    if constexpr (is_same<B, Board>::value) {
+        if (book && book->genomeKey == GenomeHash(genome.data(), GENOME_SIZE)) {
+            int col = book->probe(b);
+            if (col >= 0) return { col, 0, 0, 0, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() };
+        }
+        // Final pequeno: resolve exatamente com até metade do tempo; se não der, segue com a busca normal
+        if (solver && empty <= solverEmpty) {
+            solver->nodes = 0;
+            solver->useDeadline = true;
+            solver->deadline = start + chrono::milliseconds(timeMs / 2);
+            solver->cancelFlag = cancelFlag;
+            int value = 0;
+            int col = solver->bestMove(b, value);
+            solver->useDeadline = false; solver->cancelFlag = nullptr;
+            if (col >= 0) {
+                double score = value > 0 ? 100000000.0 + value * 1000 : (value < 0 ? -100000000.0 + value * 1000 : 0);
+                return { col, score, empty, solver->nodes, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() };
+            }
+        }
+    }
+    deadline = start + chrono::milliseconds(timeMs);
+    useDeadline = true; stopSearch = false; nodes = 0; cutoffs = 0;
+    clearOrdering();
+
+    if (maxDepth > empty) maxDepth = empty;
+
+    SearchResult best = { -1, 0, 0, 0, 0 };
+    for (int depth = min(startDepth, maxDepth); depth <= maxDepth; depth++) {
+        rootFirstMove = best.col;
+        pair<int, double> r = minimax(b, depth, -9e9, 9e9, true, piece);
+        if (stopSearch) break; // Iteração incompleta: descarta
+        best.col = r.first; best.score = r.second; best.depth = depth;
+
+        // Vitória ou derrota forçada já encontrada: ir mais fundo não muda a jogada
+        if (abs(r.second) >= 100000000.0) break;
+        // Se metade do tempo já foi gasto, a próxima iteração (bem maior) não terminaria
+        auto elapsed = chrono::steady_clock::now() - start;
+        if (elapsed * 2 >= chrono::milliseconds(timeMs)) break;
+    }
+    useDeadline = false; stopSearch = false; rootFirstMove = -1;
+
+    // Segurança: se nem a profundidade 1 terminou, joga a primeira coluna válida
+    if (best.col < 0) {
+        typename B::Moves moves;
+        b.getOptimizedMoves(moves);
+        if (!moves.empty()) best.col = moves[0];
+    }
+    best.nodes = nodes;
+    best.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return best;
+}
+
+// Tamanhos de tabuleiro compilados na biblioteca (ver BoardVariant)
+#define C4_INSTANTIATE_SEARCH(B)                                                                        \
+    template void Agent::recordCutoff<B>(const B&, int, int, int, int);                                 \
+    template double Agent::scoreBoardScan<B>(const B&, int) const;                                      \
+    template double Agent::leafScore<B>(const B&, int, int, int) const;                                 \
+    template pair<int, double> Agent::minimax<B>(B&, int, double, double, bool, int);                   \
+    template Agent::SearchResult Agent::think<B>(B&, int, int, int);
+C4_INSTANTIATE_SEARCH(Board)
+C4_INSTANTIATE_SEARCH(Board5x6)
+C4_INSTANTIATE_SEARCH(Board7x8)
@@ -0,0 +1,167 @@
+#pragma once
+// Agente do Algoritmo Genético: genoma + busca Minimax com Poda Alpha-Beta.
+#include "Board.h"
+#include "TranspositionTable.h"
+#include <array>
+#include <random>
+#include <chrono>
+#include <utility>
+#include <atomic>
+
+// Gerador de números aleatórios moderno (melhor que rand() puro para distribuição)
+// É o fluxo "mestre" da evolução: com a mesma semente, o treino é reproduzível.
+extern std::mt19937 gen;
+
+class OpeningBook;
+class Solver;
+
+// Genoma de tamanho fixo, guardado dentro do próprio Agent (copiar um agente não aloca memória)
+const int GENOME_SIZE = 4;
+typedef std::array<double, GENOME_SIZE> Genome;
+
+// Algoritmo Genético (Agente)
+struct Agent {
+    // genome[0] = Valor de controlar o centro
+    // genome[1] = Valor de ter 2 peças alinhadas
+    // genome[2] = Valor de ter 3 peças alinhadas
+    // genome[3] = Bloquear oponente 
+    Genome genome;
+    double fitness;
+
+    // Pesos da heurística já multiplicados pelas constantes de cada padrão
+    // (calculados uma vez por agente; chame updateWeights() se alterar o genoma)
+    double weights[5];
+
+    // Tabela de Transposição opcional (não pertence ao agente; nullptr = busca sem tabela)
+    TranspositionTable* tt = nullptr;
+    int searchPly = 0; // Distância da raiz na busca atual
+
+    // Controle de tempo do Aprofundamento Iterativo
+    long long nodes = 0;       // Nós visitados na busca atual
+    long long cutoffs = 0;     // Podas alpha-beta (para o benchmark)
+    bool useDeadline = false;  // A busca atual tem limite de tempo?
+    bool stopSearch = false;   // Estourou o tempo: a iteração atual é abandonada
+    std::chrono::steady_clock::time_point deadline;
+    int rootFirstMove = -1;    // Coluna analisada primeiro na raiz (melhor da iteração anterior)
+    int startDepth = 1;        // Primeira iteração do think() (Lazy SMP: threads auxiliares começam mais fundo)
+
+    // Ordenação dinâmica das jogadas: depois da coluna da Tabela de Transposição vêm as
+    // "killer moves" (jogadas que causaram poda no mesmo ply em outro ramo) e, por último,
+    // o histórico (quantas podas cada jogada já causou, por jogador e casa do tabuleiro)
+    static const int MAX_PLY = 65; // Uma casa do bitboard por ply, em qualquer tamanho de tabuleiro
+    int8_t killers[MAX_PLY][2];
+    int history[2][64];
+
+    // Livro de aberturas consultado pelo think() antes de buscar (nullptr = sem livro).
+    // Só é usado se tiver sido gerado com este mesmo genoma.
+    const OpeningBook* book = nullptr;
+    // Solver exato de finais: o think() passa a usá-lo quando restam solverEmpty casas vazias
+    // ou menos (nullptr ou 0 = desligado)
+    Solver* solver = nullptr;
+    int solverEmpty = 0;
+
+    // Folhas em lote: nos nós com profundidade restante 1, as folhas filhas são pontuadas direto
+    // das contagens do pai (leafScore), sem drop/undoMove, sem recursão e sem testar vitória de
+    // novo (o teste de vitória imediata do pai já cobre os filhos). Resultado, podas e nós
+    // contados são os mesmos. Ligado nas partidas de treino em lote (PlayTrainingGames).
+    bool batchLeaves = false;
+
+    // Busca em segundo plano (SearchWorker): pedido de cancelamento e contador de nós visível
+    // para a interface. Ambos são opcionais (nullptr na busca normal).
+    const std::atomic<bool>* cancelFlag = nullptr;
+    std::atomic<long long>* liveNodes = nullptr;
+
+    // Cria um agente com genoma aleatório (para o início da evolução)
+    Agent();
+    Agent(const Genome& g) { genome = g; fitness = 0; updateWeights(); clearOrdering(); }
+    void updateWeights();
+
+    // Esquece killers e histórico (o think() chama no início de cada busca)
+    void clearOrdering();
+    template<class B> void recordCutoff(const B& b, int col, int side, int ply, int depth);
+
+    // Liga (ou desliga, com nullptr) a Tabela de Transposição usada pelo minimax
+    void attachTable(TranspositionTable* table) {
+        tt = table;
+        if (tt) tt->bindGenome(genome.data(), GENOME_SIZE);
+    }
+
+    // Soma da heurística na ordem da varredura original: uma parcela weights[0] por pedra na
+    // coluna do meio (center) e, janela a janela na ordem de WINDOWS, a parcela de cada janela
+    // (K pedras nossas, K-1 ou K-2 com o resto vazio; K-1 do oponente com uma vazia). As janelas
+    // que valem zero não mudam a soma, então basta percorrer as de live (que pode sobrar).
+    // grown (ou nullptr): janelas que acabaram de receber uma pedra de grownSide (leafScore).
+    // São as mesmas parcelas, somadas na mesma ordem do scoreBoardScan: o double sai idêntico.
+    template<class B> double sumWindows(const B& b, int piece, int center, const uint64_t* live,
+                                        const uint64_t* grown, int grownSide) const {
+        const int K = B::CONNECT, own = piece - 1;
+        // Parcela pela diferença cp - co (+K): sem desvios no laço. Janelas com pedras dos dois
+        // lados caem no índice K, que vale zero
+        double term[2 * K + 1] = {};
+        term[2 * K] = weights[1];
+        term[2 * K - 1] = weights[2];
+        term[2 * K - 2] = weights[3];
+        term[1] = -weights[4];
+        double score = 0;
+        for (int k = center; k > 0; k--) score += weights[0];
+        for (int i = 0; i < B::WINDOW_WORDS; i++)
+            for (uint64_t m = live[i]; m; m &= m - 1) {
+                int w = i * 64 + LowestBit(m);
+                int cp = b.winCount[own][w], co = b.winCount[1 - own][w];
+                if (grown) {
+                    int g = (int)(grown[i] >> (w & 63) & 1);
+                    cp += grownSide == own ? g : 0;
+                    co += grownSide == own ? 0 : g;
+                }
+                score += term[cp && co ? K : K + cp - co];
+            }
+        return score;
+    }
+
+    // Avaliação de folha: só as janelas que pontuam, mantidas pelo Board incrementalmente
+    template<class B> double scoreBoard(const B& b, int piece) const {
+        uint64_t live[B::WINDOW_WORDS];
+        for (int i = 0; i < B::WINDOW_WORDS; i++) live[i] = b.scoring[0][i] | b.scoring[1][i];
+        return sumWindows(b, piece, PopCount(b.pieces[piece - 1] & ColumnMaskT<B::ROWS>(B::COLS / 2)), live, nullptr, 0);
+    }
+
+    // Analisa K células consecutivas e atribui uma pontuação baseada nos genes (a do scoreBoard
+    // original). cp/ce/co: Contadores de Peça, Vazio e Oponente dentro da janela
+    template<int K> double evalWindow(int cp, int ce, int co) const {
+        double score = 0;
+        if (cp == K) score += 1000000;                             // Prioriza a vitória sempre que possível
+        else if (cp == K - 1 && ce == 1) score += genome[2] * 50.0; // Favorece conectar 3 pedras
+        else if (cp == K - 2 && ce == 2) score += genome[1] * 5.0;  // Favorece (menos) conectar 2 pedras
+        if (co == K - 1 && ce == 1) score -= genome[3] * 100.0;    // Tenta evitar que o oponente conecte 3 pedras
+        return score;
+    }
+
+    // O scoreBoard original: percorre todas as janelas do zero somando evalWindow
+    // (referência para conferir a versão incremental, que tem de dar o mesmo double)
+    template<class B> double scoreBoardScan(const B& b, int piece) const;
+
+    // scoreBoard (do ponto de vista de piece) da posição com uma pedra de mover na coluna col,
+    // sem alterar o tabuleiro: só as janelas que passam pela casa nova mudam
+    template<class B> double leafScore(const B& b, int col, int mover, int piece) const;
+
+    // Chamado a cada 1024 nós: publica o contador de nós e verifica tempo e cancelamento
+    void pollSearch();
+
+    // ALGORITMO MINIMAX
+    // alpha/beta: Variáveis para "podar" (ignorar) jogadas ruins
+    // maximizing: valor booleano que indica se estamos maximizando (AG) ou minimizando a pontuação (oponente)
+    // Variante PVS: a primeira jogada usa a janela inteira e as demais só uma janela nula
+    // (basta provar que não são melhores); se alguma for, é buscada de novo com a janela inteira.
+    // A busca é um template no tipo do tabuleiro (BoardT<R, C, K>); Agent.cpp instancia
+    // Board, Board5x6 e Board7x8.
+    template<class B> std::pair<int, double> minimax(B& b, int depth, double alpha, double beta, bool maximizing, int piece);
+
+    // APROFUNDAMENTO ITERATIVO COM ORÇAMENTO DE TEMPO
+    // Busca com profundidade 1, 2, 3... até o tempo acabar e devolve o resultado da
+    // iteração mais funda que terminou. Cada iteração começa pela melhor jogada da anterior.
+    // Posições do livro de aberturas são respondidas na hora (depth 0, nenhum nó), e finais
+    // pequenos são resolvidos pelo Solver (depth = casas vazias). Livro e Solver só existem
+    // para o tabuleiro padrão; nos outros tamanhos, o think() sempre busca.
+    struct SearchResult { int col; double score; int depth; long long nodes; double ms; };
+    template<class B> SearchResult think(B& b, int piece, int timeMs, int maxDepth);
+};
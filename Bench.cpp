@@ -0,0 +1,818 @@
+// connect4-bench: benchmark do motor e do treino, com saída em JSON.
+// Modos:
+//   search  Minimax numa suíte fixa de posições em várias profundidades (nós/s, taxa de poda, tempo)
+//   train   N gerações de EvolveOneGeneration com semente fixa (partidas/s, partidas vindas do cache)
+//   rank    Qualidade do ranking das agendas do torneio (terço superior, elite e nós gastos) contra
+//           o Elo do round-robin completo, em --generations populações aleatórias
+//   perft   Conta as folhas da árvore de jogadas e compara com os valores de referência
+//   verify  Confere a avaliação incremental (e a folha pontuada pelo pai) contra a varredura
+//           completa e o scoreBoard original, bit a bit, em posições aleatórias (com undoMove),
+//           o Solver contra a força bruta em finais pequenos e o mesmo valor do Minimax e do
+//           Solver numa posição e no seu espelho
+//   eval    Folhas avaliadas por segundo: varredura completa e avaliação incremental
+//   islands Partidas/s do treino com 1 ilha e com --islands ilhas (processos separados, Island.h)
+//   smp     Tempo até a profundidade com 1 thread e com N threads (Lazy SMP) e o ganho (speedup)
+//   alloc   Conta as alocações no heap de buscas e gerações depois do aquecimento (esperado: zero)
+//   boards  Cada tamanho de tabuleiro compilado (ou só o de --board): perft, avaliação incremental e
+//           alinhamento por deslocamentos contra a varredura das janelas, e nós/s da busca
+//   batch   Partidas/s do treino jogando uma partida por vez e em lote (PlayTrainingGames), em
+//           --generations populações aleatórias, e se as partidas saem iguais
+//   threads Treino reproduzível: em cada agenda, --generations gerações com 1 thread e com N threads
+//           têm de dar os mesmos campeões e as mesmas fitness
+#include "Evolution.h"
+#include "Island.h"
+#include "ParallelSearch.h"
+#include "Solver.h"
+#include "Stats.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Alocador contador: substitui o operator new global do programa inteiro (inclusive da biblioteca)
+static atomic<long long> heapAllocs(0);
+void* operator new(size_t n) {
+    heapAllocs.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Suíte padrão: sequências de colunas (1 a 7) a partir do tabuleiro vazio, P1 começa
+static const char* SUITE[] = {
+    "",                       // Abertura: tabuleiro vazio
+    "4",                      // Resposta à abertura central
+    "4453",                   // Início de jogo
+    "44433352",               // Meio de jogo com ameaças no centro
+    "6772257244",             // Meio de jogo espalhado
+    "4743332265",             // Meio de jogo com disputa no centro
+    "4444441111233322",       // Meio/fim de jogo
+    "22525762534622441115",   // Fim de jogo (tabuleiro bem ocupado)
+};
+static const int SUITE_SIZE = sizeof(SUITE) / sizeof(SUITE[0]);
+
+// Valores de referência do perft a partir do tabuleiro vazio (profundidade 1..9).
+// Posições com vitória ou tabuleiro cheio são folhas e não são expandidas.
+// Conferidos com uma implementação independente baseada em matriz (sem bitboard).
+static const long long PERFT_EXPECTED[] = { 7, 49, 343, 2401, 16807, 117649, 823536, 5686266, 39452034 };
+
+// Monta a posição; devolve a peça de quem joga (1 ou 2) ou 0 se a sequência for inválida
+static int SetupPosition(const char* moves, Board& b) {
+    b.reset();
+    int piece = 1;
+    for (const char* m = moves; *m; m++) {
+        int c = *m - '1';
+        if (!b.isValid(c)) return 0;
+        b.drop(c, piece);
+        if (b.checkWin(piece)) return 0;
+        piece = 3 - piece;
+    }
+    return piece;
+}
+
+static double MsSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+}
+
+template<class B> static long long Perft(B& b, int depth, int piece) {
+    if (depth == 0) return 1;
+    long long leaves = 0;
+    for (int c = 0; c < B::COLS; c++) {
+        if (!b.isValid(c)) continue;
+        b.drop(c, piece);
+        if (depth == 1 || b.checkWin(piece) || b.isFull()) leaves++;
+        else leaves += Perft(b, depth - 1, 3 - piece);
+        b.undoMove(c);
+    }
+    return leaves;
+}
+
+struct Options {
+    string mode = "search";
+    vector<int> depths = { 2, 4, 6, 8 };
+    bool depthsGiven = false;
+    int generations = 3;
+    uint32_t seed = 42;
+    int threads = 0;
+    int ttMegabytes = 0;
+    int positions = 100000;
+    int islands = 4;
+    string statsPath; // Série de contadores (search: uma amostra por profundidade; train: por geração)
+    TournamentSchedule schedule = SCHEDULE_RANDOM;
+    BoardVariant board = BOARD_6X7;
+    bool boardGiven = false;
+    string gamesPath; // Log das partidas no modo train (mede o custo da gravação)
+};
+
+static int RunSearch(const Options& opt) {
+    // Genoma fixo para que os números sejam comparáveis entre versões
+    Agent agent(Genome{ 3.0, 2.0, 5.0, 4.0 });
+    TranspositionTable table(opt.ttMegabytes > 0 ? opt.ttMegabytes : 1);
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        Board b;
+        if (!SetupPosition(SUITE[i], b)) { fprintf(stderr, "Posicao invalida na suite: %s\n", SUITE[i]); return 1; }
+    }
+    StatTrace trace;
+    trace.start();
+    printf("{\n  \"mode\": \"search\",\n  \"tt_mb\": %d,\n  \"results\": [\n", opt.ttMegabytes);
+    long long totalNodes = 0, totalCutoffs = 0; double totalMs = 0;
+    bool first = true;
+    for (int depth : opt.depths) {
+        long long depthNodes = 0; double depthMs = 0;
+        for (int i = 0; i < SUITE_SIZE; i++) {
+            Board b;
+            int piece = SetupPosition(SUITE[i], b);
+            // Cada medição começa com a tabela, os killers e o histórico vazios
+            table.clear();
+            agent.attachTable(opt.ttMegabytes > 0 ? &table : nullptr);
+            agent.clearOrdering();
+            agent.nodes = 0; agent.cutoffs = 0;
+            gen.seed(opt.seed);
+            auto t0 = chrono::steady_clock::now();
+            pair<int, double> r = agent.minimax(b, depth, -9e9, 9e9, true, piece);
+            double ms = MsSince(t0);
+            printf("%s    {\"position\": \"%s\", \"depth\": %d, \"col\": %d, \"score\": %.17g, \"nodes\": %lld, "
+                   "\"cutoffs\": %lld, \"cutoff_rate\": %.4f, \"ms\": %.3f, \"nps\": %.0f, \"tt_hits\": %llu}",
+                   first ? "" : ",\n", SUITE[i], depth, r.first, r.second, agent.nodes, agent.cutoffs,
+                   agent.nodes ? (double)agent.cutoffs / agent.nodes : 0.0, ms, ms > 0 ? agent.nodes / ms * 1000.0 : 0.0,
+                   (unsigned long long)table.hits);
+            first = false;
+            depthNodes += agent.nodes; depthMs += ms;
+            totalNodes += agent.nodes; totalCutoffs += agent.cutoffs; totalMs += ms;
+        }
+        // Tempo até a profundidade: soma da suíte inteira nesta profundidade
+        const StatSnapshot& st = trace.sample("depth", depth);
+        printf(",\n    {\"suite_depth\": %d, \"time_to_depth_ms\": %.3f, \"nodes\": %lld, \"leaf_evals\": %llu, "
+               "\"immediate_wins\": %llu, \"tt_cutoffs\": %llu, \"symmetric_nodes\": %llu}", depth, depthMs, depthNodes,
+               (unsigned long long)st.count[STAT_LEAF_EVALS], (unsigned long long)st.count[STAT_IMMEDIATE_WINS],
+               (unsigned long long)st.count[STAT_TT_CUTOFFS], (unsigned long long)st.count[STAT_SYMMETRIC_NODES]);
+    }
+    if (!opt.statsPath.empty() && !trace.write(opt.statsPath)) fprintf(stderr, "Nao foi possivel gravar %s\n", opt.statsPath.c_str());
+    printf("\n  ],\n  \"total\": {\"nodes\": %lld, \"cutoffs\": %lld, \"cutoff_rate\": %.4f, \"ms\": %.3f, \"nps\": %.0f}\n}\n",
+           totalNodes, totalCutoffs, totalNodes ? (double)totalCutoffs / totalNodes : 0.0, totalMs,
+           totalMs > 0 ? totalNodes / totalMs * 1000.0 : 0.0);
+    return 0;
+}
+
+static int RunTrain(const Options& opt) {
+    evoConfig.threads = opt.threads;
+    evoConfig.schedule = opt.schedule;
+    evoConfig.board = opt.board;
+    SeedEvolution(opt.seed);
+    InitPopulation();
+    GameLog games;
+    if (!opt.gamesPath.empty()) {
+        if (!games.open(opt.gamesPath, false)) { fprintf(stderr, "Nao foi possivel abrir o log %s\n", opt.gamesPath.c_str()); return 1; }
+        trainingLog = &games;
+    }
+    printf("{\n  \"mode\": \"train\",\n  \"seed\": %u,\n  \"threads\": %d,\n  \"population\": %d,\n  \"schedule\": \"%s\",\n"
+           "  \"board\": \"%s\",\n  \"generations\": [\n", opt.seed, opt.threads, evoConfig.populationSize,
+           ScheduleName(opt.schedule), BoardVariantName(opt.board));
+    double totalMs = 0;
+    Agent champion;
+    StatTrace trace;
+    trace.start();
+    for (int g = 0; g < opt.generations; g++) {
+        TournamentStats before = tournamentStats;
+        auto t0 = chrono::steady_clock::now();
+        champion = EvolveOneGeneration();
+        double ms = MsSince(t0);
+        long long genGames = tournamentStats.games - before.games;
+        totalMs += ms;
+        // Onde foi o tempo da geração (zeros se compilado com C4_STATS=0)
+        const StatSnapshot& st = trace.sample("generation", globalGenCounter);
+        printf("%s    {\"generation\": %d, \"ms\": %.3f, \"games\": %lld, \"cached\": %lld, \"games_per_sec\": %.2f, "
+               "\"champion_fitness\": %.0f, \"matches_ms\": %.3f, \"selection_ms\": %.3f, \"reproduction_ms\": %.3f}",
+               g ? ",\n" : "", globalGenCounter, ms, genGames, tournamentStats.cached - before.cached, genGames / ms * 1000.0,
+               champion.fitness, st.ms(TIMER_MATCHES), st.ms(TIMER_SELECTION), st.ms(TIMER_REPRODUCTION));
+    }
+    if (!opt.statsPath.empty() && !trace.write(opt.statsPath)) fprintf(stderr, "Nao foi possivel gravar %s\n", opt.statsPath.c_str());
+    printf("\n  ],\n  \"champion\": [%.17g, %.17g, %.17g, %.17g],\n", champion.genome[0], champion.genome[1],
+           champion.genome[2], champion.genome[3]);
+    printf("  \"total\": {\"games\": %lld, \"cached\": %lld, \"ms\": %.3f, \"games_per_sec\": %.2f, \"logged\": %lld}\n}\n",
+           tournamentStats.games, tournamentStats.cached, totalMs, totalMs > 0 ? tournamentStats.games / totalMs * 1000.0 : 0.0,
+           games.games());
+    trainingLog = nullptr;
+    return 0;
+}
+
+// Postos de v (0 = menor; empates recebem o posto médio)
+static void Ranks(const vector<double>& v, vector<int>& idx, vector<double>& r) {
+    int n = (int)v.size();
+    idx.resize(n); r.resize(n);
+    for (int i = 0; i < n; i++) idx[i] = i;
+    sort(idx.begin(), idx.end(), [&](int x, int y) { return v[x] < v[y]; });
+    for (int i = 0; i < n;) {
+        int j = i;
+        while (j + 1 < n && v[idx[j + 1]] == v[idx[i]]) j++;
+        for (int k = i; k <= j; k++) r[idx[k]] = (i + j) / 2.0;
+        i = j + 1;
+    }
+}
+
+// Correlação de Spearman: correlação de Pearson entre os postos
+static double Spearman(const vector<double>& a, const vector<double>& b) {
+    vector<int> idx;
+    vector<double> ra, rb;
+    Ranks(a, idx, ra);
+    Ranks(b, idx, rb);
+    double ma = 0, mb = 0, sab = 0, saa = 0, sbb = 0;
+    for (size_t i = 0; i < a.size(); i++) { ma += ra[i]; mb += rb[i]; }
+    ma /= a.size(); mb /= b.size();
+    for (size_t i = 0; i < a.size(); i++) {
+        sab += (ra[i] - ma) * (rb[i] - mb); saa += (ra[i] - ma) * (ra[i] - ma); sbb += (rb[i] - mb) * (rb[i] - mb);
+    }
+    return saa > 0 && sbb > 0 ? sab / sqrt(saa * sbb) : 0;
+}
+
+// Fração dos k primeiros de ref que também estão entre os k primeiros de v (os pais da próxima
+// geração saem do terço superior; a elite são os eliteCount primeiros)
+static double TopOverlap(const vector<double>& v, const vector<double>& ref, int k) {
+    // Mesma ordem do sortByFitness em caso de empate (índice menor primeiro)
+    auto top = [k](const vector<double>& x, vector<uint8_t>& in) {
+        int n = (int)x.size();
+        vector<int> idx(n);
+        for (int i = 0; i < n; i++) idx[i] = i;
+        stable_sort(idx.begin(), idx.end(), [&](int a, int b) { return x[a] > x[b]; });
+        in.assign(n, 0);
+        for (int i = 0; i < k; i++) in[idx[i]] = 1;
+    };
+    vector<uint8_t> a, b;
+    top(v, a);
+    top(ref, b);
+    int both = 0;
+    for (size_t i = 0; i < a.size(); i++) both += a[i] && b[i];
+    return (double)both / k;
+}
+
+static int RunRank(const Options& opt) {
+    // Para cada população aleatória, a referência é o Elo do round-robin completo; as agendas
+    // random e suíça jogam o mesmo número de partidas (no suíço, cada partida conta para os dois
+    // agentes). A corrida joga o que as etapas pedirem; compare os nós (zeros com C4_STATS=0).
+    evoConfig.threads = opt.threads;
+    const int matches = evoConfig.matchesPerAgent;
+    const int populations = opt.generations;
+    const int S = 4;
+    TournamentSchedule schedules[S] = { SCHEDULE_ROUND_ROBIN, SCHEDULE_RANDOM, SCHEDULE_SWISS, SCHEDULE_RACING };
+    double games[S] = {}, ms[S] = {}, rho[S] = {}, overlap[S] = {}, elite[S] = {}, nodes[S] = {};
+    int popSize = evoConfig.populationSize, eliteCount = min(evoConfig.eliteCount, popSize);
+    vector<double> reference;
+    for (int p = 0; p < populations; p++) {
+        SeedEvolution(opt.seed + p);
+        InitPopulation();
+        for (int k = 0; k < S; k++) {
+            evoConfig.schedule = schedules[k];
+            evoConfig.matchesPerAgent = schedules[k] == SCHEDULE_SWISS ? 2 * matches : matches;
+            ResetTournamentCache(); // Sem cache: cada agenda joga todas as suas partidas
+            StatSnapshot before, after;
+            CollectStats(before);
+            auto t0 = chrono::steady_clock::now();
+            RunTournament();
+            ms[k] += MsSince(t0);
+            CollectStats(after);
+            nodes[k] += (after - before).count[STAT_NODES];
+            games[k] += tournamentStats.games;
+            if (k == 0) reference = population.fitness;
+            rho[k] += Spearman(population.fitness, reference);
+            overlap[k] += TopOverlap(population.fitness, reference, max(1, popSize / 3));
+            elite[k] += TopOverlap(population.fitness, reference, max(1, eliteCount));
+        }
+    }
+    evoConfig.matchesPerAgent = matches;
+    printf("{\n  \"mode\": \"rank\",\n  \"population\": %d,\n  \"populations\": %d,\n  \"results\": [\n",
+           evoConfig.populationSize, populations);
+    for (int k = 0; k < S; k++)
+        printf("%s    {\"schedule\": \"%s\", \"games\": %.1f, \"nodes\": %.0f, \"ms\": %.1f, \"spearman\": %.3f, "
+               "\"top_third_overlap\": %.3f, \"elite_overlap\": %.3f}", k ? ",\n" : "", ScheduleName(schedules[k]),
+               games[k] / populations, nodes[k] / populations, ms[k] / populations, rho[k] / populations,
+               overlap[k] / populations, elite[k] / populations);
+    printf("\n  ]\n}\n");
+    return 0;
+}
+
+static int RunPerft(const Options& opt) {
+    // Sem --depth explícito, vai até a profundidade 8 (menos de 1 s)
+    int maxDepth = opt.depthsGiven ? 0 : 8;
+    for (int d : opt.depths) if (opt.depthsGiven) maxDepth = max(maxDepth, d);
+    printf("{\n  \"mode\": \"perft\",\n  \"results\": [\n");
+    bool ok = true;
+    for (int d = 1; d <= maxDepth; d++) {
+        Board b;
+        auto t0 = chrono::steady_clock::now();
+        long long leaves = Perft(b, d, 1);
+        double ms = MsSince(t0);
+        int nExpected = sizeof(PERFT_EXPECTED) / sizeof(PERFT_EXPECTED[0]);
+        bool match = d > nExpected || leaves == PERFT_EXPECTED[d - 1];
+        ok = ok && match;
+        printf("%s    {\"depth\": %d, \"leaves\": %lld, \"expected\": %lld, \"match\": %s, \"ms\": %.3f}", d > 1 ? ",\n" : "",
+               d, leaves, d <= nExpected ? PERFT_EXPECTED[d - 1] : -1LL, match ? "true" : "false", ms);
+    }
+    printf("\n  ],\n  \"ok\": %s\n}\n", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+// Valor exato por força bruta (mesma escala do Solver), para conferir o Solver em finais pequenos
+static int BruteForceValue(Board& b) {
+    int moves = b.moveCount(), piece = moves % 2 == 0 ? 1 : 2, best = Solver::MIN_SCORE - 10;
+    for (int c = 0; c < COLS; c++) {
+        if (!b.isValid(c)) continue;
+        b.drop(c, piece);
+        int v = b.checkWin(piece) ? (ROWS * COLS + 1 - moves) / 2 : (b.isFull() ? 0 : -BruteForceValue(b));
+        b.undoMove(c);
+        best = max(best, v);
+    }
+    return best;
+}
+
+// Posição aleatória (pode ter 4 alinhadas: a avaliação também precisa acertar esses casos)
+template<class B> static void RandomPosition(mt19937& rng, B& b) {
+    b.reset();
+    int piece = 1, n = rng() % (B::ROWS * B::COLS);
+    int played[B::ROWS * B::COLS], count = 0;
+    for (int k = 0; k < n; k++) {
+        int c = rng() % B::COLS;
+        if (b.isValid(c)) { b.drop(c, piece); played[count++] = c; piece = 3 - piece; }
+    }
+    // Desfaz parte das jogadas para exercitar o undoMove
+    for (int k = rng() % (count + 1); k > 0; k--) b.undoMove(played[--count]);
+}
+
+// O scoreBoard da primeira versão do jogo (grade de células, antes do bitboard), copiado como era:
+// a avaliação incremental tem de dar exatamente o mesmo double
+static double BaselineScoreBoard(const Genome& genome, const Board& b, int piece) {
+    int grid[ROWS][COLS];
+    for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS; c++) grid[r][c] = b.cell(r, c);
+    auto evalWindow = [&](const int* w) {
+        double score = 0;
+        int cp = 0, ce = 0, co = 0; // Contadores: Peça, Vazio, Oponente
+        for (int i = 0; i < 4; i++) {
+            int x = w[i];
+            if (x == piece) cp++; else if (x == 0) ce++; else co++;
+        }
+        if (cp == 4) score += 1000000;
+        else if (cp == 3 && ce == 1) score += genome[2] * 50.0;
+        else if (cp == 2 && ce == 2) score += genome[1] * 5.0;
+        if (co == 3 && ce == 1) score -= genome[3] * 100.0;
+        return score;
+    };
+    double score = 0;
+    for (int r = 0; r < ROWS; r++) if (grid[r][3] == piece) score += genome[0] * 10.0;
+    int window[4];
+    for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) {
+        window[0] = grid[r][c]; window[1] = grid[r][c + 1]; window[2] = grid[r][c + 2]; window[3] = grid[r][c + 3];
+        score += evalWindow(window);
+    }
+    for (int c = 0; c < COLS; c++) for (int r = 0; r < ROWS - 3; r++) {
+        window[0] = grid[r][c]; window[1] = grid[r + 1][c]; window[2] = grid[r + 2][c]; window[3] = grid[r + 3][c];
+        score += evalWindow(window);
+    }
+    for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS - 3; c++) {
+        window[0] = grid[r][c]; window[1] = grid[r + 1][c + 1]; window[2] = grid[r + 2][c + 2]; window[3] = grid[r + 3][c + 3];
+        score += evalWindow(window);
+    }
+    for (int r = 3; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) {
+        window[0] = grid[r][c]; window[1] = grid[r - 1][c + 1]; window[2] = grid[r - 2][c + 2]; window[3] = grid[r - 3][c + 3];
+        score += evalWindow(window);
+    }
+    return score;
+}
+
+static int RunVerify(const Options& opt) {
+    mt19937 rng(opt.seed);
+    long long mismatches = 0;
+    for (int i = 0; i < opt.positions; i++) {
+        uniform_real_distribution<double> d(-10.0, 10.0);
+        Agent a(Genome{ d(rng), d(rng), d(rng), d(rng) });
+        Board b;
+        RandomPosition(rng, b);
+        for (int p = 1; p <= 2; p++) {
+            double inc = a.scoreBoard(b, p), scan = a.scoreBoardScan(b, p), base = BaselineScoreBoard(a.genome, b, p);
+            if (memcmp(&inc, &scan, sizeof(double)) != 0 || memcmp(&inc, &base, sizeof(double)) != 0) mismatches++;
+            // Folha pontuada a partir do pai (partidas em lote) contra o drop de verdade
+            for (int c = 0; c < COLS; c++) {
+                if (!b.isValid(c)) continue;
+                int mover = 1 + (b.moveCount() + p) % 2;
+                double leaf = a.leafScore(b, c, mover, p);
+                b.drop(c, mover);
+                double dropped = a.scoreBoard(b, p);
+                b.undoMove(c);
+                if (memcmp(&leaf, &dropped, sizeof(double)) != 0) mismatches++;
+            }
+        }
+    }
+    // Solver contra força bruta em finais com até 10 casas vazias
+    Solver solver(16);
+    long long solverMismatches = 0;
+    int endgames = max(1, opt.positions / 100);
+    for (int i = 0; i < endgames;) {
+        Board b;
+        int piece = 1, empty = 1 + rng() % 10;
+        bool won = false;
+        while (!won && ROWS * COLS - b.moveCount() > empty) {
+            int c = rng() % COLS;
+            if (!b.isValid(c)) continue;
+            b.drop(c, piece);
+            won = b.checkWin(piece);
+            piece = 3 - piece;
+        }
+        if (won) continue;
+        int value = BruteForceValue(b);
+        Board m;
+        m.mirrorFrom(b);
+        if (solver.solve(b) != value) solverMismatches++;
+        if (solver.solve(m) != value) solverMismatches++; // O cache guarda o espelho na mesma entrada
+        i++;
+    }
+    // Espelho: a posição espelhada tem o mesmo valor no Minimax (sem e com Tabela de Transposição,
+    // que guarda as duas na mesma entrada), e o hash e a chave espelhados batem com os do espelho.
+    // O valor só bate a menos do arredondamento: a heurística soma as mesmas parcelas, mas o
+    // espelho percorre as janelas em outra ordem
+    TranspositionTable table(1);
+    long long mirrorMismatches = 0;
+    for (int i = 0; i < endgames; i++) {
+        uniform_real_distribution<double> d(-10.0, 10.0);
+        Agent a(Genome{ d(rng), d(rng), d(rng), d(rng) });
+        Board b, m;
+        RandomPosition(rng, b);
+        if (b.checkWin(1) || b.checkWin(2) || b.isFull()) continue;
+        m.mirrorFrom(b);
+        if (m.hash != b.mirrorHash || m.mirrorHash != b.hash || m.key() != b.mirroredKey()) mirrorMismatches++;
+        int piece = b.moveCount() % 2 + 1, depth = 1 + i % 5;
+        for (int useTable = 0; useTable < 2; useTable++) {
+            a.attachTable(useTable ? &table : nullptr);
+            if (useTable) table.clear();
+            double v = a.minimax(b, depth, -9e9, 9e9, true, piece).second;
+            if (useTable) table.clear();
+            double w = a.minimax(m, depth, -9e9, 9e9, true, piece).second;
+            if (fabs(v - w) > 1e-9 * max(1.0, fabs(v))) mirrorMismatches++;
+        }
+    }
+    bool ok = mismatches == 0 && solverMismatches == 0 && mirrorMismatches == 0;
+    printf("{\n  \"mode\": \"verify\",\n  \"positions\": %d,\n  \"eval_mismatches\": %lld,\n  \"endgames\": %d,\n"
+           "  \"solver_mismatches\": %lld,\n  \"mirror_mismatches\": %lld,\n  \"ok\": %s\n}\n",
+           opt.positions, mismatches, endgames, solverMismatches, mirrorMismatches, ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+// Mede uma forma de avaliar todas as posições; repete até somar ~2 milhões de folhas
+template <class F>
+static double LeavesPerSecond(int positions, F evaluate) {
+    int reps = max(1, 2000000 / positions);
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) evaluate();
+    double ms = MsSince(t0);
+    return ms > 0 ? (double)positions * reps / ms * 1000.0 : 0;
+}
+
+static int RunEval(const Options& opt) {
+    mt19937 rng(opt.seed);
+    Agent a(Genome{ 3.0, 2.0, 5.0, 4.0 });
+    int n = opt.positions;
+    vector<Board> boards(n);
+    for (int i = 0; i < n; i++) RandomPosition(rng, boards[i]);
+    vector<double> reference(n), out(n);
+    double scanRate = LeavesPerSecond(n, [&] { for (int i = 0; i < n; i++) reference[i] = a.scoreBoardScan(boards[i], 1); });
+    long long mismatches = 0;
+    auto check = [&] { for (int i = 0; i < n; i++) if (memcmp(&out[i], &reference[i], sizeof(double)) != 0) mismatches++; };
+    double incRate = LeavesPerSecond(n, [&] { for (int i = 0; i < n; i++) out[i] = a.scoreBoard(boards[i], 1); });
+    check();
+    printf("{\n  \"mode\": \"eval\",\n  \"positions\": %d,\n  \"leaves_per_sec\": {\"scan\": %.0f, \"incremental\": %.0f},\n"
+           "  \"speedup\": %.2f,\n  \"mismatches\": %lld,\n  \"ok\": %s\n}\n",
+           n, scanRate, incRate, scanRate > 0 ? incRate / scanRate : 0.0, mismatches, mismatches == 0 ? "true" : "false");
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Alinhamento pela tabela de janelas (referência para o hasAlignment com deslocamentos)
+template<class B> static bool HasAlignmentScan(uint64_t m) {
+    for (int w = 0; w < B::NUM_WINDOWS; w++) if ((m & B::WINDOWS.mask[w]) == B::WINDOWS.mask[w]) return true;
+    return false;
+}
+
+// Um tamanho de tabuleiro: imprime o objeto JSON e devolve se todas as conferências passaram
+template<class B> static bool BenchBoard(const Options& opt, B b, BoardVariant v, bool first) {
+    printf("%s    {\"board\": \"%s\", \"connect\": %d, \"windows\": %d,\n      \"perft\": [", first ? "" : ",\n",
+           BoardVariantName(v), B::CONNECT, B::NUM_WINDOWS);
+    // Até 2K-2 jogadas ninguém vence, e até R nenhuma coluna enche: são C^d folhas exatas
+    bool ok = true;
+    for (int d = 1; d <= 6; d++) {
+        auto t0 = chrono::steady_clock::now();
+        long long leaves = Perft(b, d, 1), expected = -1;
+        double ms = MsSince(t0);
+        if (is_same<B, Board>::value) expected = PERFT_EXPECTED[d - 1];
+        else if (d <= 2 * B::CONNECT - 2 && d <= B::ROWS) { expected = 1; for (int k = 0; k < d; k++) expected *= B::COLS; }
+        ok = ok && (expected < 0 || leaves == expected);
+        printf("%s{\"depth\": %d, \"leaves\": %lld, \"expected\": %lld, \"ms\": %.3f}", d > 1 ? ", " : "", d, leaves,
+               expected, ms);
+    }
+    // Avaliação incremental e hasAlignment contra a varredura de todas as janelas
+    mt19937 rng(opt.seed);
+    long long evalMismatches = 0, alignMismatches = 0;
+    for (int i = 0; i < opt.positions; i++) {
+        uniform_real_distribution<double> d(-10.0, 10.0);
+        Agent a(Genome{ d(rng), d(rng), d(rng), d(rng) });
+        RandomPosition(rng, b);
+        for (int p = 1; p <= 2; p++) {
+            double inc = a.scoreBoard(b, p), scan = a.scoreBoardScan(b, p);
+            if (memcmp(&inc, &scan, sizeof(double)) != 0) evalMismatches++;
+            if (b.checkWin(p) != HasAlignmentScan<B>(b.pieces[p - 1])) alignMismatches++;
+        }
+    }
+    ok = ok && evalMismatches == 0 && alignMismatches == 0;
+    printf("],\n      \"positions\": %d, \"eval_mismatches\": %lld, \"alignment_mismatches\": %lld,\n      \"search\": [",
+           opt.positions, evalMismatches, alignMismatches);
+    // Busca a partir do tabuleiro vazio, com as mesmas condições do modo search
+    Agent agent(Genome{ 3.0, 2.0, 5.0, 4.0 });
+    b.reset();
+    for (size_t k = 0; k < opt.depths.size(); k++) {
+        agent.attachTable(nullptr);
+        agent.clearOrdering();
+        agent.nodes = 0; agent.cutoffs = 0;
+        gen.seed(opt.seed);
+        auto t0 = chrono::steady_clock::now();
+        pair<int, double> r = agent.minimax(b, opt.depths[k], -9e9, 9e9, true, 1);
+        double ms = MsSince(t0);
+        printf("%s{\"depth\": %d, \"col\": %d, \"nodes\": %lld, \"ms\": %.3f, \"nps\": %.0f}", k ? ", " : "",
+               opt.depths[k], r.first, agent.nodes, ms, ms > 0 ? agent.nodes / ms * 1000.0 : 0.0);
+    }
+    printf("],\n      \"ok\": %s}", ok ? "true" : "false");
+    return ok;
+}
+
+static int RunBoards(const Options& opt) {
+    printf("{\n  \"mode\": \"boards\",\n  \"results\": [\n");
+    bool ok = true, first = true;
+    for (int v = 0; v < NUM_BOARD_VARIANTS; v++) {
+        if (opt.boardGiven && v != opt.board) continue;
+        ok = WithBoard((BoardVariant)v, [&](auto b) { return BenchBoard(opt, b, (BoardVariant)v, first); }) && ok;
+        first = false;
+    }
+    printf("\n  ],\n  \"ok\": %s\n}\n", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+static int RunSmp(const Options& opt) {
+    int depth = opt.depthsGiven ? opt.depths.back() : 12;
+    ThreadPool single(1), parallel(opt.threads);
+    TranspositionTable table(opt.ttMegabytes > 0 ? opt.ttMegabytes : 64);
+    Agent agent(Genome{ 3.0, 2.0, 5.0, 4.0 });
+    printf("{\n  \"mode\": \"smp\",\n  \"depth\": %d,\n  \"threads\": %d,\n  \"results\": [\n", depth, parallel.size());
+    double total1 = 0, totalN = 0;
+    int same = 0;
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        Board b;
+        int piece = SetupPosition(SUITE[i], b);
+        Agent::SearchResult r[2];
+        double ms[2];
+        for (int k = 0; k < 2; k++) {
+            // Mesma profundidade, sem limite de tempo prático; cada medição começa com a tabela vazia
+            table.clear();
+            agent.attachTable(&table);
+            auto t0 = chrono::steady_clock::now();
+            r[k] = LazySmpThink(k == 0 ? single : parallel, agent, b, piece, 1000000, depth);
+            ms[k] = MsSince(t0);
+        }
+        total1 += ms[0]; totalN += ms[1];
+        if (r[0].col == r[1].col) same++;
+        printf("%s    {\"position\": \"%s\", \"ms_1\": %.3f, \"ms_n\": %.3f, \"speedup\": %.2f, \"col_1\": %d, \"col_n\": %d, "
+               "\"nodes_1\": %lld, \"nodes_n\": %lld}", i ? ",\n" : "", SUITE[i], ms[0], ms[1], ms[1] > 0 ? ms[0] / ms[1] : 0.0,
+               r[0].col, r[1].col, r[0].nodes, r[1].nodes);
+    }
+    printf("\n  ],\n  \"total\": {\"ms_1\": %.3f, \"ms_n\": %.3f, \"speedup\": %.2f, \"same_move\": %d, \"positions\": %d}\n}\n",
+           total1, totalN, totalN > 0 ? total1 / totalN : 0.0, same, SUITE_SIZE);
+    return 0;
+}
+
+static int RunIslandsBench(const Options& opt) {
+    // Cada ilha tem a população padrão; com N ilhas, a população total é N vezes maior
+    evoConfig.threads = opt.threads;
+    evoConfig.schedule = opt.schedule;
+    printf("{\n  \"mode\": \"islands\",\n  \"seed\": %u,\n  \"population_per_island\": %d,\n  \"generations\": %d,\n"
+           "  \"results\": [\n", opt.seed, evoConfig.populationSize, opt.generations);
+    double rate[2] = { 0, 0 };
+    for (int k = 0; k < 2; k++) {
+        IslandConfig cfg;
+        cfg.islands = k == 0 ? 1 : opt.islands;
+        cfg.generations = opt.generations;
+        cfg.migrateEvery = 1;
+        cfg.seed = opt.seed;
+        IslandResult result;
+        auto t0 = chrono::steady_clock::now();
+        if (!RunIslands(cfg, nullptr, result)) { fprintf(stderr, "O treino em ilhas falhou\n"); return 1; }
+        double ms = MsSince(t0);
+        rate[k] = result.games / ms * 1000.0;
+        printf("%s    {\"islands\": %d, \"games\": %lld, \"cached\": %lld, \"ms\": %.3f, \"games_per_sec\": %.2f, "
+               "\"champion_island\": %d}", k ? ",\n" : "", cfg.islands, result.games, result.cached, ms, rate[k],
+               result.championIsland);
+    }
+    printf("\n  ],\n  \"scaling\": %.2f\n}\n", rate[0] > 0 ? rate[1] / rate[0] : 0.0);
+    return 0;
+}
+
+static int RunBatch(const Options& opt) {
+    // As partidas de --generations populações aleatórias (matchesPerAgent por agente, oponentes
+    // sorteados), jogadas uma por vez com PlayTrainingGame e em lote com PlayTrainingGames, numa
+    // thread só. O cache de aberturas começa vazio nas duas; jogadas e vencedores têm de bater.
+    evoConfig.board = opt.board;
+    const int depth = evoConfig.trainingDepth;
+    mt19937 rng(opt.seed);
+    vector<Pairing> pairings;
+    vector<int> games, winners[2];
+    vector<GameRecord> records[2];
+    double ms[2] = { 0, 0 };
+    long long total = 0, mismatches = 0;
+    for (int p = 0; p < opt.generations; p++) {
+        SeedEvolution(opt.seed + p);
+        InitPopulation();
+        int n = population.size();
+        pairings.clear();
+        for (int i = 0; i < n; i++)
+            for (int m = 0; m < evoConfig.matchesPerAgent; m++) {
+                int o = rng() % (n - 1);
+                pairings.push_back({ i, o < i ? o : o + 1 });
+            }
+        int count = (int)pairings.size();
+        games.resize(count);
+        for (int t = 0; t < count; t++) games[t] = t;
+        for (int k = 0; k < 2; k++) {
+            winners[k].assign(count, 0);
+            records[k].resize(count);
+            ResetTournamentCache();
+            auto t0 = chrono::steady_clock::now();
+            if (k == 0) {
+                for (int t = 0; t < count; t++) {
+                    Agent p1 = population.agent(pairings[t].p1), p2 = population.agent(pairings[t].p2);
+                    winners[0][t] = PlayTrainingGame(p1, p2, depth, &records[0][t]);
+                }
+            }
+            else PlayTrainingGames(pairings.data(), games.data(), count, depth, winners[1].data(), records[1].data());
+            ms[k] += MsSince(t0);
+        }
+        for (int t = 0; t < count; t++) {
+            const GameRecord &a = records[0][t], &b = records[1][t];
+            bool same = winners[0][t] == winners[1][t] && a.count == b.count && a.winner == b.winner && a.flags == b.flags;
+            for (int j = 0; same && j < a.count; j++) same = a.move(j) == b.move(j);
+            mismatches += !same;
+        }
+        total += count;
+    }
+    bool ok = mismatches == 0;
+    printf("{\n  \"mode\": \"batch\",\n  \"board\": \"%s\",\n  \"depth\": %d,\n  \"games\": %lld,\n"
+           "  \"one_at_a_time\": {\"ms\": %.3f, \"games_per_sec\": %.2f},\n"
+           "  \"lockstep\": {\"ms\": %.3f, \"games_per_sec\": %.2f},\n  \"speedup\": %.2f,\n"
+           "  \"mismatches\": %lld,\n  \"ok\": %s\n}\n", BoardVariantName(opt.board), depth, total,
+           ms[0], ms[0] > 0 ? total / ms[0] * 1000.0 : 0.0, ms[1], ms[1] > 0 ? total / ms[1] * 1000.0 : 0.0,
+           ms[1] > 0 ? ms[0] / ms[1] : 0.0, mismatches, ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+static int RunThreads(const Options& opt) {
+    // Em cada agenda, as mesmas gerações com semente fixa numa thread e em N threads. Antes de
+    // cada geração, o torneio é jogado à parte para guardar a fitness de todos os indivíduos; o
+    // gerador mestre volta ao estado anterior e EvolveOneGeneration joga o mesmo torneio (cache).
+    const int N = opt.threads > 1 ? opt.threads : max(2, (int)thread::hardware_concurrency());
+    const int S = 4;
+    TournamentSchedule schedules[S] = { SCHEDULE_RANDOM, SCHEDULE_ROUND_ROBIN, SCHEDULE_SWISS, SCHEDULE_RACING };
+    vector<double> fitness[2], champions[2];
+    long long totalMismatches = 0;
+    printf("{\n  \"mode\": \"threads\",\n  \"seed\": %u,\n  \"threads\": %d,\n  \"generations\": %d,\n  \"results\": [\n",
+           opt.seed, N, opt.generations);
+    for (int k = 0; k < S; k++) {
+        evoConfig.schedule = schedules[k];
+        for (int t = 0; t < 2; t++) {
+            evoConfig.threads = t == 0 ? 1 : N;
+            fitness[t].clear();
+            champions[t].clear();
+            SeedEvolution(opt.seed);
+            InitPopulation();
+            for (int g = 0; g < opt.generations; g++) {
+                mt19937 saved = gen;
+                RunTournament();
+                fitness[t].insert(fitness[t].end(), population.fitness.begin(), population.fitness.end());
+                gen = saved;
+                Agent champion = EvolveOneGeneration();
+                champions[t].insert(champions[t].end(), champion.genome.begin(), champion.genome.end());
+                champions[t].push_back(champion.fitness);
+            }
+        }
+        long long mismatches = 0;
+        for (size_t i = 0; i < fitness[0].size(); i++) mismatches += fitness[0][i] != fitness[1][i];
+        bool sameChampions = champions[0] == champions[1];
+        totalMismatches += mismatches + !sameChampions;
+        printf("%s    {\"schedule\": \"%s\", \"same_champions\": %s, \"fitness_mismatches\": %lld}", k ? ",\n" : "",
+               ScheduleName(schedules[k]), sameChampions ? "true" : "false", mismatches);
+    }
+    evoConfig.schedule = SCHEDULE_RANDOM;
+    evoConfig.threads = 0;
+    bool ok = totalMismatches == 0;
+    printf("\n  ],\n  \"ok\": %s\n}\n", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+static int RunAlloc(const Options& opt) {
+    // Aquecimento: a primeira geração cria o pool de threads e os buffers do torneio e do log
+    // de partidas (ligado, só em memória: a gravação também não pode alocar)
+    evoConfig.threads = opt.threads;
+    SeedEvolution(opt.seed);
+    InitPopulation();
+    GameLog games;
+    trainingLog = &games;
+    EvolveOneGeneration();
+    TranspositionTable table(opt.ttMegabytes > 0 ? opt.ttMegabytes : 16);
+    Agent agent(Genome{ 3.0, 2.0, 5.0, 4.0 });
+    agent.attachTable(&table);
+
+    long long before = heapAllocs.load();
+    for (int i = 0; i < SUITE_SIZE; i++) {
+        Board b;
+        int piece = SetupPosition(SUITE[i], b);
+        for (int depth : opt.depths) agent.minimax(b, depth, -9e9, 9e9, true, piece);
+        agent.think(b, piece, 20, 42);
+    }
+    long long searchAllocs = heapAllocs.load() - before;
+
+    before = heapAllocs.load();
+    for (int g = 0; g < opt.generations; g++) EvolveOneGeneration();
+    long long trainAllocs = heapAllocs.load() - before;
+    trainingLog = nullptr;
+
+    bool ok = searchAllocs == 0 && trainAllocs == 0;
+    printf("{\n  \"mode\": \"alloc\",\n  \"search_allocs\": %lld,\n  \"generations\": %d,\n  \"train_allocs\": %lld,\n"
+           "  \"ok\": %s\n}\n", searchAllocs, opt.generations, trainAllocs, ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
+
+static void PrintUsage() {
+    fprintf(stderr, "Uso: connect4-bench [search|train|rank|perft|verify|eval|islands|smp|alloc|boards|batch|threads] [opcoes]\n"
+                    "  --depth a,b,c    Profundidades (search, boards) ou profundidade maxima (perft, smp; padrao do smp: 12)\n"
+                    "  --generations N  Geracoes nos modos train, islands, alloc e threads; populacoes nos modos rank e batch (padrao 3)\n"
+                    "  --seed S         Semente (padrao 42)\n"
+                    "  --threads N      Threads do torneio (train, alloc; islands: por ilha; threads: o N comparado com 1)\n"
+                    "                   ou da busca (smp) (padrao 0 = uma por nucleo, no minimo 2 no modo threads;\n"
+                    "                   islands: a fatia de nucleos da ilha)\n"
+                    "  --schedule S     Agenda do torneio nos modos train e islands: random (padrao), round-robin, swiss\n"
+                    "                   ou racing\n"
+                    "  --islands N      Ilhas (processos) no modo islands (padrao 4)\n"
+                    "  --stats ARQUIVO  Contadores por profundidade (search) ou por geracao (train) em CSV (.csv) ou JSON\n"
+                    "  --tt MB          Tabela de Transposicao no modo search (padrao 0 = desligada; smp: 64)\n"
+                    "  --positions N    Posicoes aleatorias nos modos verify, eval e boards (padrao 100000; verify: 1%% delas em finais)\n"
+                    "  --board B        Tabuleiro dos modos train e batch ou o unico medido no modo boards: 6x7 (padrao), 5x6 ou 7x8\n"
+                    "  --games ARQUIVO  Grava as partidas do modo train neste log (custo da gravacao)\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    int i = 1;
+    if (argc > 1 && argv[1][0] != '-') opt.mode = argv[i++];
+    for (; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--depth") && hasValue) {
+            opt.depths.clear(); opt.depthsGiven = true;
+            for (char* p = argv[++i]; *p;) {
+                opt.depths.push_back((int)strtol(p, &p, 10));
+                if (*p == ',') p++; else if (*p) break;
+            }
+        }
+        else if (!strcmp(arg, "--generations") && hasValue) opt.generations = atoi(argv[++i]);
+        else if (!strcmp(arg, "--seed") && hasValue) opt.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--threads") && hasValue) opt.threads = atoi(argv[++i]);
+        else if (!strcmp(arg, "--tt") && hasValue) opt.ttMegabytes = atoi(argv[++i]);
+        else if (!strcmp(arg, "--positions") && hasValue) opt.positions = atoi(argv[++i]);
+        else if (!strcmp(arg, "--islands") && hasValue) opt.islands = atoi(argv[++i]);
+        else if (!strcmp(arg, "--stats") && hasValue) opt.statsPath = argv[++i];
+        else if (!strcmp(arg, "--games") && hasValue) opt.gamesPath = argv[++i];
+        else if (!strcmp(arg, "--schedule") && hasValue) {
+            if (!ParseSchedule(argv[++i], opt.schedule)) { PrintUsage(); return 1; }
+        }
+        else if (!strcmp(arg, "--board") && hasValue) {
+            if (!ParseBoardVariant(argv[++i], opt.board)) { PrintUsage(); return 1; }
+            opt.boardGiven = true;
+        }
+        else { PrintUsage(); return 1; }
+    }
+    if (opt.mode == "search") return RunSearch(opt);
+    if (opt.mode == "train") return RunTrain(opt);
+    if (opt.mode == "rank") return RunRank(opt);
+    if (opt.mode == "perft") return RunPerft(opt);
+    if (opt.mode == "verify") return RunVerify(opt);
+    if (opt.mode == "eval") return RunEval(opt);
+    if (opt.mode == "islands") return RunIslandsBench(opt);
+    if (opt.mode == "smp") return RunSmp(opt);
+    if (opt.mode == "alloc") return RunAlloc(opt);
+    if (opt.mode == "boards") return RunBoards(opt);
+    if (opt.mode == "batch") return RunBatch(opt);
+    if (opt.mode == "threads") return RunThreads(opt);
+    PrintUsage();
+    return 1;
+}
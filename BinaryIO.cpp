@@ -0,0 +1,42 @@
+#include "BinaryIO.h"
+#include <cstdio>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+using namespace std;
+
+bool WriteFileAtomic(const string& path, vector<uint8_t>& data) {
+    PutU64(data, Fnv1a(data.data(), data.size()));
+    string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool written = fwrite(data.data(), 1, data.size(), f) == data.size();
+    written = (fflush(f) == 0) && written;
+    written = (fclose(f) == 0) && written;
+    if (!written) { remove(tmp.c_str()); return false; }
+#if defined(_WIN32)
+    if (!MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        remove(tmp.c_str()); return false;
+    }
+#else
+    if (rename(tmp.c_str(), path.c_str()) != 0) { remove(tmp.c_str()); return false; }
+#endif
+    return true;
+}
+
+bool ReadFileChecked(const string& path, vector<uint8_t>& data) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    data.clear();
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+    if (data.size() < 8) return false;
+    ByteReader tail{ data.data() + data.size() - 8, 8 };
+    if (tail.u64() != Fnv1a(data.data(), data.size() - 8)) return false;
+    data.resize(data.size() - 8);
+    return true;
+}
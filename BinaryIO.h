@@ -0,0 +1,44 @@
+#pragma once
+// Utilitários dos formatos binários (checkpoint, livro de aberturas, log de partidas): codificação
+// little-endian explícita, checksum e gravação atômica de arquivos.
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+inline void PutU16(std::vector<uint8_t>& out, uint16_t v) { out.push_back((uint8_t)v); out.push_back((uint8_t)(v >> 8)); }
+inline void PutU32(std::vector<uint8_t>& out, uint32_t v) { for (int i = 0; i < 4; i++) out.push_back((uint8_t)(v >> (8 * i))); }
+inline void PutU64(std::vector<uint8_t>& out, uint64_t v) { for (int i = 0; i < 8; i++) out.push_back((uint8_t)(v >> (8 * i))); }
+inline void PutF64(std::vector<uint8_t>& out, double v) { uint64_t bits; memcpy(&bits, &v, sizeof(bits)); PutU64(out, bits); }
+
+// Leitor com verificação de limites: qualquer leitura além do fim marca os dados como inválidos
+struct ByteReader {
+    const uint8_t* p; size_t left; bool ok = true;
+    uint64_t get(int bytes) {
+        if ((size_t)bytes > left) { ok = false; return 0; }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++) v |= (uint64_t)p[i] << (8 * i);
+        p += bytes; left -= bytes;
+        return v;
+    }
+    uint8_t u8() { return (uint8_t)get(1); }
+    uint16_t u16() { return (uint16_t)get(2); }
+    uint32_t u32() { return (uint32_t)get(4); }
+    int32_t i32() { return (int32_t)get(4); }
+    uint64_t u64() { return get(8); }
+    double f64() { uint64_t bits = get(8); double v; memcpy(&v, &bits, sizeof(v)); return v; }
+};
+
+inline uint64_t Fnv1a(const uint8_t* data, size_t n) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < n; i++) h = (h ^ data[i]) * 0x100000001B3ULL;
+    return h;
+}
+
+// Acrescenta o checksum ao final e grava o arquivo de forma atômica: os dados vão para
+// "<path>.tmp" e só então substituem o arquivo antigo, então uma queda no meio da gravação
+// nunca deixa um arquivo pela metade
+bool WriteFileAtomic(const std::string& path, std::vector<uint8_t>& data);
+
+// Lê o arquivo inteiro e confere o checksum do final; devolve os dados sem o checksum
+bool ReadFileChecked(const std::string& path, std::vector<uint8_t>& data);
@@ -0,0 +1,376 @@
+#pragma once
+// Tabuleiro do Connect 4 (bitboard) e tabelas auxiliares.
+// Não depende da raylib: é compartilhado pela interface e pelas ferramentas de linha de comando.
+#include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Dimensões do Tabuleiro padrão. Outras dimensões usam BoardT<linhas, colunas, conexão>
+// (ver abaixo); ROWS, COLS e as tabelas globais (WINDOWS, BOTTOM_MASK...) são as do padrão.
+const int ROWS = 6;
+const int COLS = 7;
+const int CONNECT = 4; // Pedras em linha para vencer
+
+// Contagem de bits ligados (usada pelo bitboard)
+// Usa a instrução POPCNT quando o compilador a habilita; senão, a soma paralela de bits (SWAR)
+inline int PopCount(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (int)__popcnt64(x);
+#elif defined(__POPCNT__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Índice do bit ligado mais baixo (x != 0)
+inline int LowestBit(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Layout do Bitboard
+// Cada coluna ocupa R + 1 bits consecutivos, de baixo para cima.
+// O bit extra no topo de cada coluna fica sempre vazio e serve de "sentinela",
+// impedindo que os deslocamentos (shifts) de uma coluna vazem para a próxima.
+// Tudo abaixo é calculado em tempo de compilação para cada tamanho de tabuleiro (R linhas, C colunas).
+
+// Índice do bit da célula (r, c), com r = 0 sendo a linha do topo (como na tela)
+template<int R> constexpr int CellBitT(int r, int c) { return c * (R + 1) + (R - 1 - r); }
+
+// Máscara com todas as células de uma coluna
+template<int R> constexpr uint64_t ColumnMaskT(int c) { return ((1ULL << R) - 1) << (c * (R + 1)); }
+
+// Bit da linha de baixo de cada coluna
+template<int R, int C> constexpr uint64_t BottomMaskT() {
+    uint64_t m = 0;
+    for (int c = 0; c < C; c++) m |= 1ULL << (c * (R + 1));
+    return m;
+}
+
+// Espelha um bitboard na horizontal (coluna c <-> coluna C-1-c). Leva a sentinela junto, então
+// também espelha chaves de posição (pedras + ocupadas + linha de baixo).
+template<int R, int C> inline uint64_t MirrorBitsT(uint64_t m) {
+    uint64_t r = 0;
+    for (int c = 0; c < C; c++) r |= ((m >> (c * (R + 1))) & ColumnMaskT<R + 1>(0)) << ((C - 1 - c) * (R + 1));
+    return r;
+}
+
+// Quantidade de janelas de K células (horizontais, verticais e as duas diagonais)
+template<int R, int C, int K> constexpr int NumWindows() {
+    return R * (C - K + 1) + C * (R - K + 1) + 2 * (R - K + 1) * (C - K + 1);
+}
+
+// Máscaras das janelas de K células, na ordem de varredura original do scoreBoard
+// (Horizontal, Vertical, Diagonal Principal, Diagonal Secundária).
+template<int R, int C, int K>
+struct WindowTableT {
+    uint64_t mask[NumWindows<R, C, K>()];
+    constexpr WindowTableT() : mask() {
+        int w = 0;
+        for (int r = 0; r < R; r++) for (int c = 0; c + K <= C; c++, w++)
+            for (int i = 0; i < K; i++) mask[w] |= 1ULL << CellBitT<R>(r, c + i);
+        for (int c = 0; c < C; c++) for (int r = 0; r + K <= R; r++, w++)
+            for (int i = 0; i < K; i++) mask[w] |= 1ULL << CellBitT<R>(r + i, c);
+        for (int r = 0; r + K <= R; r++) for (int c = 0; c + K <= C; c++, w++)
+            for (int i = 0; i < K; i++) mask[w] |= 1ULL << CellBitT<R>(r + i, c + i);
+        for (int r = K - 1; r < R; r++) for (int c = 0; c + K <= C; c++, w++)
+            for (int i = 0; i < K; i++) mask[w] |= 1ULL << CellBitT<R>(r - i, c + i);
+    }
+};
+
+// Janelas que passam por cada célula (no máximo K por direção), usadas na atualização incremental
+template<int R, int C, int K>
+struct CellWindowTableT {
+    static const int MAX = 4 * K;
+    uint8_t count[64];
+    uint8_t list[64][MAX];
+    constexpr CellWindowTableT() : count(), list() {
+        constexpr WindowTableT<R, C, K> windows;
+        for (int w = 0; w < NumWindows<R, C, K>(); w++) for (int bit = 0; bit < 64; bit++)
+            if (windows.mask[w] & (1ULL << bit)) list[bit][count[bit]++] = (uint8_t)w;
+    }
+};
+
+// Ordem das colunas do centro para as bordas (C = 7: 3, 2, 4, 1, 5, 0, 6)
+template<int C>
+struct CenterOrderT {
+    int col[C];
+    constexpr CenterOrderT() : col() {
+        int n = 0;
+        col[n++] = C / 2;
+        for (int d = 1; n < C; d++) {
+            if (C / 2 - d >= 0) col[n++] = C / 2 - d;
+            if (C / 2 + d < C) col[n++] = C / 2 + d;
+        }
+    }
+};
+
+// Chaves de Zobrist: um número aleatório fixo para cada (jogador, bit do tabuleiro).
+// O hash de uma posição é o XOR das chaves das pedras presentes, então pode ser
+// atualizado a cada jogada com um único XOR.
+constexpr uint64_t SplitMix64(uint64_t& s) {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+struct ZobristTable {
+    uint64_t piece[2][64];
+    uint64_t side[2][2]; // [peça da AG - 1][maximizing]: diferencia quem está pensando e de quem é a vez
+    constexpr ZobristTable() : piece(), side() {
+        uint64_t s = 0x436F6E6E65637434ULL;
+        for (int p = 0; p < 2; p++) for (int i = 0; i < 64; i++) piece[p][i] = SplitMix64(s);
+        for (int p = 0; p < 2; p++) for (int m = 0; m < 2; m++) side[p][m] = SplitMix64(s);
+    }
+};
+constexpr ZobristTable ZOBRIST;
+
+// Lista de jogadas com capacidade fixa (no máximo C), alocada na pilha:
+// o minimax não faz alocação no heap em nenhum nó
+template<int C>
+struct MoveListT {
+    int col[C];
+    int size = 0;
+
+    int* begin() { return col; }
+    int* end() { return col + size; }
+    const int* begin() const { return col; }
+    const int* end() const { return col + size; }
+    bool empty() const { return size == 0; }
+    int operator[](int i) const { return col[i]; }
+    void push(int c) { col[size++] = c; }
+
+    // Traz a coluna c para a frente, mantendo a ordem das demais (nada muda se c não estiver na lista)
+    void moveToFront(int c) {
+        for (int i = 0; i < size; i++) if (col[i] == c) {
+            for (; i > 0; i--) col[i] = col[i - 1];
+            col[0] = c;
+            return;
+        }
+    }
+};
+
+// Tabuleiro (Bitboard) com R linhas, C colunas e K em linha para vencer.
+// Cada tamanho é um tipo próprio: as tabelas são constantes de compilação e os laços
+// sobre colunas, janelas e direções têm limites fixos, então o compilador os desenrola.
+template<int R, int C, int K>
+class BoardT {
+    static_assert(C * (R + 1) <= 64, "o bitboard (com as sentinelas) precisa caber em 64 bits");
+    static_assert(K >= 3 && K <= R && K <= C, "a heurística conta janelas com K, K-1 e K-2 pedras");
+    static_assert(NumWindows<R, C, K>() <= 255, "os índices das janelas são guardados em uint8_t");
+
+public:
+    static constexpr int ROWS = R, COLS = C, CONNECT = K;
+    static constexpr int HEIGHT = R + 1; // Bits por coluna (com a sentinela)
+    static constexpr int NUM_WINDOWS = NumWindows<R, C, K>();
+    static constexpr int WINDOW_WORDS = (NUM_WINDOWS + 63) / 64; // Palavras de um conjunto de janelas
+    static constexpr uint64_t BOTTOM = BottomMaskT<R, C>();
+    static constexpr WindowTableT<R, C, K> WINDOWS{};
+    static constexpr CellWindowTableT<R, C, K> CELL_WINDOWS{};
+    static constexpr CenterOrderT<C> ORDER{};
+    typedef MoveListT<C> Moves;
+    // Espelhar o tabuleiro (coluna c <-> C-1-c) não muda o valor da posição: as janelas vão
+    // nelas mesmas e a coluna do centro, que a heurística conta à parte, só existe com C ímpar
+    static constexpr bool SYMMETRIC = C % 2 == 1;
+
+    uint64_t pieces[2]; // pieces[0] = Pedras do P1, pieces[1] = Pedras do P2
+    int height[C];      // Quantidade de pedras em cada coluna (0 = vazia, R = cheia)
+    uint64_t hash;      // Hash de Zobrist da posição, mantido por drop/undoMove
+    uint64_t mirrorHash; // Hash da posição espelhada (igual a hash numa posição simétrica)
+
+    // Avaliação incremental (mantida por drop/undoMove):
+    // winCount[p][w] = pedras do jogador p+1 na janela w
+    // scoring[p]     = janelas (bit w % 64 da palavra w / 64) com pelo menos K-2 pedras do jogador
+    //                  p+1 e nenhuma do oponente: as únicas que pontuam na heurística
+    uint8_t winCount[2][NUM_WINDOWS];
+    uint64_t scoring[2][WINDOW_WORDS];
+
+    BoardT() { reset(); }
+
+    // Limpa o tabuleiro
+    void reset() {
+        pieces[0] = pieces[1] = 0;
+        hash = mirrorHash = 0;
+        for (int c = 0; c < C; c++) height[c] = 0;
+        for (int p = 0; p < 2; p++) {
+            for (int w = 0; w < NUM_WINDOWS; w++) winCount[p][w] = 0;
+            for (int i = 0; i < WINDOW_WORDS; i++) scoring[p][i] = 0;
+        }
+    }
+
+    // Copia o estado de outro tabuleiro (para simulação do Minimax)
+    void copyFrom(const BoardT& o) { *this = o; }
+
+    // Monta o espelho de outro tabuleiro (a ordem das pedras não importa para o estado)
+    void mirrorFrom(const BoardT& o) {
+        reset();
+        for (int c = 0; c < C; c++)
+            for (int h = 0; h < o.height[c]; h++) drop(C - 1 - c, (o.pieces[0] >> (c * HEIGHT + h)) & 1 ? 1 : 2);
+    }
+
+    // Conteúdo da célula (r, c): 0 = Vazio, 1 = Pedra do P1, 2 = Pedra do P2
+    int cell(int r, int c) const {
+        uint64_t bit = 1ULL << CellBitT<R>(r, c);
+        if (pieces[0] & bit) return 1;
+        if (pieces[1] & bit) return 2;
+        return 0;
+    }
+
+    // Verifica se a coluna não está cheia
+    bool isValid(int c) const { return c >= 0 && c < C && height[c] < R; }
+
+    // Coloca a peça na coluna (só liga o bit da nova pedra)
+    void drop(int c, int p) {
+        if (height[c] < R) {
+            int bit = c * HEIGHT + height[c];
+            pieces[p - 1] |= 1ULL << bit;
+            hash ^= ZOBRIST.piece[p - 1][bit];
+            mirrorHash ^= ZOBRIST.piece[p - 1][(C - 1 - c) * HEIGHT + height[c]];
+            height[c]++;
+            addToWindows(bit, p - 1);
+        }
+    }
+
+    // Remove a pedra do topo da coluna (só desliga o bit removido)
+    void undoMove(int c) {
+        if (height[c] > 0) {
+            height[c]--;
+            int bit = c * HEIGHT + height[c];
+            int owner = (pieces[0] >> bit) & 1 ? 0 : 1;
+            hash ^= ZOBRIST.piece[owner][bit];
+            mirrorHash ^= ZOBRIST.piece[owner][(C - 1 - c) * HEIGHT + height[c]];
+            removeFromWindows(bit, owner);
+            uint64_t keep = ~(1ULL << bit);
+            pieces[0] &= keep;
+            pieces[1] &= keep;
+        }
+    }
+
+    // Chave única da posição (sem colisões): pedras do P1 + (ocupadas + linha de baixo).
+    // A soma deixa um único bit logo acima da pilha de cada coluna, marcando a altura;
+    // abaixo dele ficam as pedras do P1. De quem é a vez sai da quantidade de pedras.
+    static uint64_t positionKey(uint64_t p1, uint64_t p2) { return p1 + ((p1 | p2) + BOTTOM); }
+    uint64_t key() const { return positionKey(pieces[0], pieces[1]); }
+    uint64_t mirroredKey() const { return positionKey(MirrorBitsT<R, C>(pieces[0]), MirrorBitsT<R, C>(pieces[1])); }
+
+    // A posição é igual ao seu espelho? (os hashes só filtram: a confirmação é exata)
+    bool isSymmetric() const {
+        return hash == mirrorHash && pieces[0] == MirrorBitsT<R, C>(pieces[0]) && pieces[1] == MirrorBitsT<R, C>(pieces[1]);
+    }
+
+    // Quantidade de pedras no tabuleiro
+    int moveCount() const { return PopCount(pieces[0] | pieces[1]); }
+
+    // Sequências de K pedras na direção d (distância em bits entre células vizinhas):
+    // m & (m >> d) marca os inícios de pares, repetindo com 2d sobram os de 4, e assim por
+    // diante dobrando; um último passo completa o que faltar até K (K = 4: só os dois passos).
+    template<int D> static bool hasRun(uint64_t m) {
+        int len = 1;
+        for (; 2 * len <= K; len *= 2) m &= m >> (len * D);
+        if (len < K) m &= m >> ((K - len) * D);
+        return m != 0;
+    }
+
+    // Verifica se há K em linha numa máscara de pedras usando deslocamentos
+    static bool hasAlignment(uint64_t m) {
+        return hasRun<HEIGHT>(m)        // Horizontal
+            || hasRun<1>(m)             // Vertical
+            || hasRun<HEIGHT + 1>(m)    // Diagonal Secundária
+            || hasRun<HEIGHT - 1>(m);   // Diagonal Principal
+    }
+
+    // Verifica todas as direções para ver se alguém ganhou
+    bool checkWin(int p) const { return hasAlignment(pieces[p - 1]); }
+
+    // Verifica empate (tabuleiro cheio)
+    bool isFull() const { return PopCount(pieces[0] | pieces[1]) == R * C; }
+
+    // Atualiza só as janelas que passam pela célula alterada.
+    // Uma janela sem pedras do oponente entra em scoring ao chegar a K-2 pedras do jogador;
+    // quando recebe a primeira pedra do outro lado, deixa de pontuar para quem a ocupava.
+    void addToWindows(int bit, int p) {
+        for (int i = 0; i < CELL_WINDOWS.count[bit]; i++) {
+            int w = CELL_WINDOWS.list[bit][i];
+            int a = winCount[p][w], o = winCount[1 - p][w];
+            uint64_t m = 1ULL << (w & 63);
+            if (o == 0 && a + 1 == K - 2) scoring[p][w >> 6] |= m;
+            if (a == 0 && o >= K - 2) scoring[1 - p][w >> 6] &= ~m;
+            winCount[p][w] = (uint8_t)(a + 1);
+        }
+    }
+    void removeFromWindows(int bit, int p) {
+        for (int i = 0; i < CELL_WINDOWS.count[bit]; i++) {
+            int w = CELL_WINDOWS.list[bit][i];
+            int a = winCount[p][w] - 1, o = winCount[1 - p][w];
+            uint64_t m = 1ULL << (w & 63);
+            if (o == 0 && a + 1 == K - 2) scoring[p][w >> 6] &= ~m;
+            if (a == 0 && o >= K - 2) scoring[1 - p][w >> 6] |= m;
+            winCount[p][w] = (uint8_t)a;
+        }
+    }
+
+    // OTIMIZAÇÃO PARA MINIMAX (Poda Alpha-Beta):
+    // O algoritmo deve verificar o centro do tabuleiro primeiro
+    // porque o centro oferece mais oportunidades de vitória, permitindo
+    // que a "poda" (corte de cálculos desnecessários) aconteça mais cedo
+    void getOptimizedMoves(Moves& moves) const {
+        moves.size = 0;
+        for (int c : ORDER.col) { // Ordem: Meio -> Bordas
+            if (height[c] < R) moves.push(c);
+        }
+    }
+};
+
+// Tabuleiro padrão (6x7, 4 em linha) e os nomes globais que o resto do código usa para ele
+typedef BoardT<ROWS, COLS, CONNECT> Board;
+typedef MoveListT<COLS> MoveList;
+const int BB_HEIGHT = Board::HEIGHT;
+constexpr int CellBit(int r, int c) { return CellBitT<ROWS>(r, c); }
+constexpr uint64_t ColumnMask(int c) { return ColumnMaskT<ROWS>(c); }
+const uint64_t BOTTOM_MASK = Board::BOTTOM;
+inline uint64_t MirrorBits(uint64_t m) { return MirrorBitsT<ROWS, COLS>(m); }
+const int NUM_WINDOWS = Board::NUM_WINDOWS;
+inline constexpr const WindowTableT<ROWS, COLS, CONNECT>& WINDOWS = Board::WINDOWS;
+const int MAX_CELL_WINDOWS = CellWindowTableT<ROWS, COLS, CONNECT>::MAX;
+inline constexpr const CellWindowTableT<ROWS, COLS, CONNECT>& CELL_WINDOWS = Board::CELL_WINDOWS;
+
+// Variantes compiladas na biblioteca. A busca (Agent) é instanciada para cada uma, e o
+// tamanho é escolhido ao iniciar o programa (EvolutionConfig::board, --board nas ferramentas).
+typedef BoardT<5, 6, 4> Board5x6;
+typedef BoardT<7, 8, 4> Board7x8;
+enum BoardVariant { BOARD_6X7 = 0, BOARD_5X6, BOARD_7X8, NUM_BOARD_VARIANTS };
+
+inline const char* BoardVariantName(BoardVariant v) {
+    switch (v) {
+    case BOARD_5X6: return "5x6";
+    case BOARD_7X8: return "7x8";
+    default: return "6x7";
+    }
+}
+
+inline bool ParseBoardVariant(const char* name, BoardVariant& out) {
+    for (int v = 0; v < NUM_BOARD_VARIANTS; v++)
+        if (!strcmp(name, BoardVariantName((BoardVariant)v))) { out = (BoardVariant)v; return true; }
+    return false;
+}
+
+// Chama f com um tabuleiro vazio do tipo da variante: f(Board()), f(Board5x6()) ou f(Board7x8()).
+// Com um lambda genérico ([&](auto board) { ... }), cada variante ganha o seu código especializado.
+template<class F> auto WithBoard(BoardVariant v, F&& f) -> decltype(f(Board())) {
+    switch (v) {
+    case BOARD_5X6: return f(Board5x6());
+    case BOARD_7X8: return f(Board7x8());
+    default: return f(Board());
+    }
+}
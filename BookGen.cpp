@@ -0,0 +1,84 @@
+// connect4-book: gera o livro de aberturas com o genoma treinado (rode de novo após cada treino).
+// Uso: connect4-book [--genome arquivo | --checkpoint arquivo] [--ply N] [--depth N]
+//                    [--side 1|2|0] [--threads N] [--out arquivo]
+#include "Checkpoint.h"
+#include "OpeningBook.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+using namespace std;
+
+static void PrintUsage() {
+    printf("Uso: connect4-book [opcoes]\n"
+           "  --genome ARQUIVO      Genoma campeao do connect4-train (padrao champion.txt)\n"
+           "  --checkpoint ARQUIVO  Usa o melhor agente de um checkpoint (ex.: connect4.ckpt)\n"
+           "  --ply N               Cobre as posicoes com menos de N pedras (padrao 8)\n"
+           "  --depth N             Profundidade do Minimax em cada posicao (padrao 10)\n"
+           "  --side S              Lado do livro: 1, 2 ou 0 = ambos (padrao 2, o lado da AG no jogo)\n"
+           "  --threads N           Threads da geracao (padrao 0 = uma por nucleo)\n"
+           "  --out ARQUIVO         Onde gravar o livro (padrao connect4.book)\n");
+}
+
+// Lê o genoma no formato do connect4-train: um gene por linha
+static bool ReadGenome(const char* path, Genome& g) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    bool ok = true;
+    for (double& v : g) ok = ok && fscanf(f, "%lf", &v) == 1;
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* genomePath = "champion.txt";
+    const char* checkpointPath = nullptr;
+    const char* outPath = "connect4.book";
+    int ply = 8, depth = 10, side = 2, threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) { PrintUsage(); return 0; }
+        else if (!strcmp(arg, "--genome") && hasValue) genomePath = argv[++i];
+        else if (!strcmp(arg, "--checkpoint") && hasValue) checkpointPath = argv[++i];
+        else if (!strcmp(arg, "--ply") && hasValue) ply = atoi(argv[++i]);
+        else if (!strcmp(arg, "--depth") && hasValue) depth = atoi(argv[++i]);
+        else if (!strcmp(arg, "--side") && hasValue) side = atoi(argv[++i]);
+        else if (!strcmp(arg, "--threads") && hasValue) threads = atoi(argv[++i]);
+        else if (!strcmp(arg, "--out") && hasValue) outPath = argv[++i];
+        else { fprintf(stderr, "Argumento invalido: %s\n", arg); PrintUsage(); return 1; }
+    }
+    if (ply < 1 || ply > ROWS * COLS || depth < 1 || side < 0 || side > 2) {
+        fprintf(stderr, "Parametros invalidos\n");
+        return 1;
+    }
+
+    Genome genome;
+    if (checkpointPath) {
+        CheckpointExtras extras;
+        if (!LoadCheckpoint(checkpointPath, extras) || !extras.hasBest) {
+            fprintf(stderr, "Checkpoint invalido: %s\n", checkpointPath);
+            return 1;
+        }
+        genome = extras.best;
+    }
+    else if (!ReadGenome(genomePath, genome)) {
+        fprintf(stderr, "Nao foi possivel ler o genoma de %s\n", genomePath);
+        return 1;
+    }
+
+    printf("Gerando livro: genoma [%.3f %.3f %.3f %.3f], ate %d pedras, depth %d, lado %d\n",
+           genome[0], genome[1], genome[2], genome[3], ply, depth, side);
+    fflush(stdout);
+    auto start = chrono::steady_clock::now();
+    OpeningBook book;
+    book.build(genome, ply, depth, side, threads);
+    double total = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%zu posicoes em %.1f s\n", book.size(), total);
+
+    if (!book.save(outPath)) { fprintf(stderr, "Nao foi possivel gravar %s\n", outPath); return 1; }
+    printf("Livro gravado em %s\n", outPath);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "Checkpoint.h"
+#include "BinaryIO.h"
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+static const char CHECKPOINT_MAGIC[4] = { 'C', '4', 'C', 'K' };
+
+bool SaveCheckpoint(const string& path, const CheckpointExtras& extras) {
+    vector<uint8_t> out(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + 4);
+    PutU32(out, CHECKPOINT_VERSION);
+    PutU32(out, (uint32_t)globalGenCounter);
+    PutU32(out, (uint32_t)extras.batch);
+    // Configuração da evolução (para continuar exatamente com os mesmos parâmetros)
+    PutU32(out, (uint32_t)evoConfig.trainingDepth);
+    PutU32(out, (uint32_t)evoConfig.matchesPerAgent);
+    PutU32(out, (uint32_t)evoConfig.eliteCount);
+    PutF64(out, evoConfig.mutationRate);
+    PutU32(out, (uint32_t)evoConfig.schedule);
+    PutU32(out, (uint32_t)evoConfig.board);
+    // Melhor de todos
+    PutU32(out, extras.hasBest ? 1 : 0);
+    for (double g : extras.best) PutF64(out, g);
+    PutF64(out, extras.bestFitness);
+    // População
+    PutU32(out, (uint32_t)population.size());
+    PutU32(out, (uint32_t)GENOME_SIZE);
+    for (int i = 0; i < population.size(); i++) {
+        for (int k = 0; k < GENOME_SIZE; k++) PutF64(out, population.gene[k][i]);
+        PutF64(out, population.fitness[i]);
+    }
+    // Estado do gerador mestre (formato de texto padrão do mt19937)
+    ostringstream rngText;
+    rngText << gen;
+    string s = rngText.str();
+    PutU32(out, (uint32_t)s.size());
+    out.insert(out.end(), s.begin(), s.end());
+    return WriteFileAtomic(path, out);
+}
+
+bool LoadCheckpoint(const string& path, CheckpointExtras& extras) {
+    vector<uint8_t> data;
+    if (!ReadFileChecked(path, data)) return false;
+    if (data.size() < 8 || memcmp(data.data(), CHECKPOINT_MAGIC, 4) != 0) return false;
+
+    ByteReader r{ data.data() + 4, data.size() - 4 };
+    uint32_t version = r.u32();
+    if (version < 1 || version > CHECKPOINT_VERSION) return false;
+    int genCounter = r.i32();
+    CheckpointExtras ex;
+    ex.batch = r.i32();
+    EvolutionConfig cfg = evoConfig;
+    cfg.trainingDepth = r.i32();
+    cfg.matchesPerAgent = r.i32();
+    cfg.eliteCount = r.i32();
+    cfg.mutationRate = r.f64();
+    // A versão 1 não tinha agenda do torneio: era sempre a de oponentes aleatórios
+    uint32_t schedule = version >= 2 ? r.u32() : (uint32_t)SCHEDULE_RANDOM;
+    if (schedule > SCHEDULE_RACING) return false;
+    cfg.schedule = (TournamentSchedule)schedule;
+    // Antes da versão 3, o treino era sempre no tabuleiro padrão
+    uint32_t board = version >= 3 ? r.u32() : (uint32_t)BOARD_6X7;
+    if (board >= NUM_BOARD_VARIANTS) return false;
+    cfg.board = (BoardVariant)board;
+    ex.hasBest = r.u32() != 0;
+    for (double& g : ex.best) g = r.f64();
+    ex.bestFitness = r.f64();
+    int popSize = r.i32();
+    if (r.u32() != (uint32_t)GENOME_SIZE || popSize < 2 || (size_t)popSize * (GENOME_SIZE + 1) * 8 > r.left) return false;
+    Population pop;
+    pop.reserve(popSize);
+    for (int i = 0; i < popSize; i++) {
+        Genome g;
+        for (double& v : g) v = r.f64();
+        pop.push(g, r.f64());
+    }
+    uint32_t rngLen = r.u32();
+    if (!r.ok || rngLen > r.left) return false;
+    istringstream rngText(string((const char*)r.p, rngLen));
+    mt19937 rng;
+    if (!(rngText >> rng)) return false;
+
+    // Tudo validado: só agora altera o estado global
+    population.swap(pop);
+    cfg.populationSize = popSize;
+    evoConfig = cfg;
+    globalGenCounter = genCounter;
+    gen = rng;
+    extras = ex;
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+// Checkpoints do treino: grava e restaura a evolução inteira num arquivo binário pequeno
+// (população, fitness, contadores de geração, estado do gerador aleatório e o campeão).
+// Com isso o jogo abre direto no GAMEPLAY ou continua o treino de onde parou.
+#include "Evolution.h"
+#include <string>
+
+// Formato: "C4CK" + versão; inteiros e doubles em little-endian, checksum FNV-1a no final (BinaryIO.h)
+// Versão 2: agenda do torneio (evoConfig.schedule). Versão 3: tamanho do tabuleiro
+// (evoConfig.board). Arquivos das versões 1 e 2 ainda são lidos.
+const uint32_t CHECKPOINT_VERSION = 3;
+
+// Dados da aplicação que vão junto com a evolução
+struct CheckpointExtras {
+    int batch = 0;           // Lotes da interface já concluídos (currentBatch)
+    bool hasBest = false;    // bestOfAllTime já foi definido?
+    Genome best = {};        // Genoma do melhor agente de todos
+    double bestFitness = 0;
+};
+
+// Grava population, globalGenCounter, evoConfig e o estado de gen.
+// A escrita é atômica: vai para "<path>.tmp" e só então substitui o arquivo antigo.
+bool SaveCheckpoint(const std::string& path, const CheckpointExtras& extras);
+
+// Restaura tudo o que SaveCheckpoint gravou. Se o arquivo estiver ausente, corrompido ou
+// for de uma versão mais nova, devolve false e não altera nada.
+bool LoadCheckpoint(const std::string& path, CheckpointExtras& extras);
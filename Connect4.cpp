@@ -1,17 +1,17 @@
 #include "raylib.h"
+#include "Checkpoint.h"
+#include "OpeningBook.h"
+#include "Solver.h"
+#include "SearchWorker.h"
+#include "Stats.h"
+#include <cstdio>
 #include <iostream>
 #include <vector>
 #include <algorithm>
-#include <random>
-#include <limits>
 #include <string>
 
 using namespace std;
 
-// Dimensões do Tabuleiro
-const int ROWS = 6;
-const int COLS = 7;
-
 // Visuais (Raylib)
 const int CELL_SIZE = 90;
 const int SCREEN_WIDTH = 1200;
@@ -21,11 +21,21 @@ const int MINI_CELL_SIZE = 30;
 const int MINI_BOARD_W = COLS * MINI_CELL_SIZE;
 const int MINI_BOARD_H = ROWS * MINI_CELL_SIZE;
 
-// Genética
-const int POPULATION_SIZE = 50;
+// Genética (lotes exibidos na interface)
 const int GENERATIONS_PER_BATCH = 10;
 const int TOTAL_BATCHES = 5;
-const double MUTATION_RATE = 0.20;
+
+// Motor de jogo
+const int ENGINE_TT_MB = 64; // Orçamento de memória da Tabela de Transposição usada no GAMEPLAY
+const int ENGINE_THREADS = 0;       // Threads da busca no GAMEPLAY (Lazy SMP; 0 = uma por núcleo)
+const int ENGINE_SOLVER_EMPTY = 24; // Casas vazias a partir das quais DIFICIL e IMPOSSIVEL jogam o final exato
+
+// Checkpoint gravado ao fim de cada lote de treino (permite jogar sem treinar de novo)
+const char* CHECKPOINT_PATH = "connect4.ckpt";
+// Livro de aberturas gerado pelo connect4-book (usado em DIFICIL e IMPOSSIVEL)
+const char* BOOK_PATH = "connect4.book";
+// Log com todas as partidas do treino (o replay dos lotes sai dele; leia com o connect4-games)
+const char* GAMES_PATH = "connect4.games";
 
 // Cores
 Color BLUE_BOARD = { 0, 80, 180, 255 };
@@ -33,10 +43,6 @@ Color RED_P1 = { 230, 40, 55, 255 };
 Color YEL_P2 = { 255, 220, 0, 255 };
 Color BG_COLOR = { 20, 20, 20, 255 };
 
-// Gerador de números aleatórios moderno (melhor que rand() puro para distribuição)
-random_device rd;
-mt19937 gen(rd());
-
 // Estados da Aplicação (Máquina de Estados)
 enum AppState {
     MENU,           // Tela inicial de seleção
@@ -49,309 +55,108 @@ enum AppState {
 // Quanto maior a profundidade, mais jogadas à frente a AG vê (e mais lento fica).
 enum Difficulty { EASY = 2, MEDIUM = 4, HARD = 7, IMPOSSIBLE = 9 };
 
-// Tabuleiro
-class Board {
-public:
-    int grid[ROWS][COLS]; // 0 = Vazio, 1 = Pedra do P1, 2 = Pedra do P2
-    int height[COLS];
-
-    Board() { reset(); }
-
-    // Limpa o tabuleiro
-    void reset() {
-        for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS; c++) grid[r][c] = 0;
-        for (int c = 0; c < COLS; c++) height[c] = ROWS - 1;
-    }
-
-    // Copia o estado de outro tabuleiro (para simulação do Minimax)
-    void copyFrom(const Board& o) {
-        for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS; c++) grid[r][c] = o.grid[r][c];
-        for (int c = 0; c < COLS; c++) height[c] = o.height[c];
-    }
-
-    // Verifica se a coluna não está cheia
-    bool isValid(int c) const { return c >= 0 && c < COLS && height[c] >= 0; }
-
-    // Coloca a peça na coluna
-    void drop(int c, int p) {
-        if (height[c] >= 0) {
-            grid[height[c]][c] = p;
-            height[c]--;
-        }
-    }
-
-    void undoMove(int c) {
-        if (height[c] < ROWS - 1) {
-            height[c]++;
-            grid[height[c]][c] = 0;
-        }
-    }
-
-    // Verifica todas as direções para ver se alguém ganhou
-    bool checkWin(int p) const {
-        // Horizontal
-        for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) if (grid[r][c] == p && grid[r][c + 1] == p && grid[r][c + 2] == p && grid[r][c + 3] == p) return true;
-        // Vertical
-        for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS; c++) if (grid[r][c] == p && grid[r + 1][c] == p && grid[r + 2][c] == p && grid[r + 3][c] == p) return true;
-        // Diagonal Principal
-        for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS - 3; c++) if (grid[r][c] == p && grid[r + 1][c + 1] == p && grid[r + 2][c + 2] == p && grid[r + 3][c + 3] == p) return true;
-        // Diagonal Secundária
-        for (int r = 3; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) if (grid[r][c] == p && grid[r - 1][c + 1] == p && grid[r - 2][c + 2] == p && grid[r - 3][c + 3] == p) return true;
-        return false;
-    }
-
-    // Verifica empate (tabuleiro cheio)
-    bool isFull() const {
-        for (int c = 0; c < COLS; c++) if (height[c] >= 0) return false;
-        return true;
-    }
-
-    // OTIMIZAÇÃO PARA MINIMAX (Poda Alpha-Beta):
-    // O algoritmo deve verificar o centro do tabuleiro primeiro
-    // porque o centro oferece mais oportunidades de vitória, permitindo
-    // que a "poda" (corte de cálculos desnecessários) aconteça mais cedo
-    void getOptimizedMoves(vector<int>& moves) const {
-        moves.clear();
-        static const int order[] = { 3, 2, 4, 1, 5, 0, 6 }; // Ordem: Meio -> Bordas
-        for (int c : order) {
-            if (height[c] >= 0) moves.push_back(c);
-        }
-    }
-};
-
-// Algoritmo Genético (Agente)
-struct Agent {
-    // genome[0] = Valor de controlar o centro
-    // genome[1] = Valor de ter 2 peças alinhadas
-    // genome[2] = Valor de ter 3 peças alinhadas
-    // genome[3] = Bloquear oponente 
-    vector<double> genome;
-    double fitness;
-
-    // Cria um agente com genoma aleatório (para o início da evolução)
-    Agent() {
-        uniform_real_distribution<double> d(-10.0, 10.0);
-        genome = { d(gen), d(gen), d(gen), d(gen) };
-        fitness = 0;
-    }
-    Agent(vector<double> g) { genome = g; fitness = 0; }
-
-    // Analisa 4 células consecutivas e atribui uma pontuação baseada nos genes
-    double evalWindow(const int* w, int piece) {
-        double score = 0;
-        int cp = 0, ce = 0, co = 0; // Contadores: Peça, Vazio, Oponente
-        for (int i = 0; i < 4; i++) {
-            int x = w[i];
-            if (x == piece) cp++; else if (x == 0) ce++; else co++;
-        }
-
-        // Prioriza a vitória sempre que possível
-        if (cp == 4) score += 1000000;
-        // Favorece conectar 3 pedras
-        else if (cp == 3 && ce == 1) score += genome[2] * 50.0;
-        // Favorece (menos) conectar 2 pedras
-        else if (cp == 2 && ce == 2) score += genome[1] * 5.0;
-        // Tenta evitar que o oponente conecte 3 pedras
-        if (co == 3 && ce == 1) score -= genome[3] * 100.0;
-        return score;
-    }
-
-    // Percorre todo o tabuleiro somando os pontos de cada jogada
-    double scoreBoard(const Board& b, int piece) {
-        double score = 0;
-        // 1. Controle de Centro - Peças no meio valem mais
-        for (int r = 0; r < ROWS; r++) if (b.grid[r][3] == piece) score += genome[0] * 10.0;
-
-        // 2. Scan de Janelas (Horizontal, Vertical, Diagonais)
-        // Isso passa "janelas deslizantes" de 4 espaços pelo tabuleiro inteiro
-        int window[4];
-        for (int r = 0; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) {
-            window[0] = b.grid[r][c]; window[1] = b.grid[r][c + 1]; window[2] = b.grid[r][c + 2]; window[3] = b.grid[r][c + 3];
-            score += evalWindow(window, piece);
-        }
-        for (int c = 0; c < COLS; c++) for (int r = 0; r < ROWS - 3; r++) {
-            window[0] = b.grid[r][c]; window[1] = b.grid[r + 1][c]; window[2] = b.grid[r + 2][c]; window[3] = b.grid[r + 3][c];
-            score += evalWindow(window, piece);
-        }
-        for (int r = 0; r < ROWS - 3; r++) for (int c = 0; c < COLS - 3; c++) {
-            window[0] = b.grid[r][c]; window[1] = b.grid[r + 1][c + 1]; window[2] = b.grid[r + 2][c + 2]; window[3] = b.grid[r + 3][c + 3];
-            score += evalWindow(window, piece);
-        }
-        for (int r = 3; r < ROWS; r++) for (int c = 0; c < COLS - 3; c++) {
-            window[0] = b.grid[r][c]; window[1] = b.grid[r - 1][c + 1]; window[2] = b.grid[r - 2][c + 2]; window[3] = b.grid[r - 3][c + 3];
-            score += evalWindow(window, piece);
-        }
-        return score;
-    }
-
-    // ALGORITMO MINIMAX
-    // alpha/beta: Variáveis para "podar" (ignorar) jogadas ruins
-    // maximizing: valor booleano que indica se estamos maximizando (AG) ou minimizando a pontuação (oponente)
-    pair<int, double> minimax(Board& b, int depth, double alpha, double beta, bool maximizing, int piece) {
-        // Verifica condições de fim de jogo
-        bool term = b.checkWin(1) || b.checkWin(2) || b.isFull();
-        int opp = (piece == 1) ? 2 : 1;
-
-        if (depth == 0 || term) {
-            if (term) {
-                // Prioriza vitória mais rápida e evita derrota imediata 
-                if (b.checkWin(piece)) return { -1, 100000000.0 + depth * 1000 };
-                else if (b.checkWin(opp)) return { -1, -100000000.0 - depth * 1000 };
-                else return { -1, 0 }; // Empate
-            }
-            // Se não acabou, retorna o mapa de pontuação
-            return { -1, scoreBoard(b, piece) };
-        }
-
-        vector<int> moves;
-        b.getOptimizedMoves(moves); // Pega movimentos ordenados (Centro -> Bordas)
-
-        // Antes de simular recursivamente, verifica se consegue ganhar
-        // Se houver vitória imediata, ignora o centro e joga na vitória
-        if (maximizing) {
-            for (int col : moves) {
-                b.drop(col, piece);
-                if (b.checkWin(piece)) {
-                    b.undoMove(col);
-                    return { col, 100000000.0 + depth * 1000 };
-                }
-                b.undoMove(col);
-            }
-        }
-        else {
-            // Se o oponente puder ganhar agora, bloqueie imediatamente
-            for (int col : moves) {
-                b.drop(col, opp);
-                if (b.checkWin(opp)) {
-                    b.undoMove(col);
-                    return { col, -100000000.0 - depth * 1000 };
-                }
-                b.undoMove(col);
-            }
-        }
-        // --------------------------------------------
-        //Deixa de priorizar o centro se o peso do gene é baixo demais (a ordenação para de salvar tempo)
-        if (depth <= 2 && abs(genome[0]) < 0.1) shuffle(moves.begin(), moves.end(), gen);
-
-        if (maximizing) { // Vez da AG
-            double maxEval = -numeric_limits<double>::infinity();
-            int bestCol = (moves.size() > 0) ? moves[0] : -1;
-            for (int col : moves) {
-                b.drop(col, piece); // Simula jogada
-                double eval = minimax(b, depth - 1, alpha, beta, false, piece).second; // Recursão
-                b.undoMove(col);
-
-                if (eval > maxEval) { maxEval = eval; bestCol = col; }
-                alpha = max(alpha, eval);
-                if (beta <= alpha) break; // PODA ALPHA-BETA: Corta o loop se achar caminho melhor
-            }
-            return { bestCol, maxEval };
-        }
-        else { // Vez do Oponente (tenta minimizar o score da AG)
-            double minEval = numeric_limits<double>::infinity();
-            int bestCol = (moves.size() > 0) ? moves[0] : -1;
-            for (int col : moves) {
-                b.drop(col, opp);   // Simula jogada
-                double eval = minimax(b, depth - 1, alpha, beta, true, piece).second; // Recurso
-                b.undoMove(col);
-
-                if (eval < minEval) { minEval = eval; bestCol = col; }
-                beta = min(beta, eval);
-                if (beta <= alpha) break; // PODA
-            }
-            return { bestCol, minEval };
-        }
+// Cada dificuldade vira um orçamento de tempo por jogada para o Aprofundamento Iterativo.
+// FACIL e MEDIO continuam limitados à profundidade original para não ficarem fortes demais;
+// DIFICIL e IMPOSSIVEL vão tão fundo quanto o tempo deixar (mais fundo nos finais de jogo).
+struct DifficultyConfig { int timeMs; int maxDepth; };
+DifficultyConfig GetDifficultyConfig(int difficulty) {
+    switch (difficulty) {
+    case EASY:   return { 100, EASY };
+    case MEDIUM: return { 250, MEDIUM };
+    case HARD:   return { 1000, ROWS * COLS };
+    default:     return { 3000, ROWS * COLS };
     }
-};
+}
 
 // Variáveis Globais
-vector<Agent> population;
 Agent bestOfAllTime;
 int currentBatch = 0;
-int globalGenCounter = 0;
 int selectedDifficulty = MEDIUM;
 int gensCalculatedInThisBatch = 0;
 
+// Partida de exibição: uma partida de verdade do torneio, lida do log (o replay não busca nada)
 struct MiniMatch {
-    Board board;
-    Agent p1; Agent p2;
-    int turn; bool gameOver; int genID; float timer;
+    GameRecord game;    // Jogadas gravadas
+    uint64_t pieces[2]; // Pedras já mostradas de cada jogador
+    int shown; int genID; float timer;
+    bool gameOver() const { return shown >= game.count; }
 };
 vector<MiniMatch> batchMatches;
 
-// Reseta a população para o estado inicial
-void InitPopulation() {
-    population.clear();
-    for (int i = 0; i < POPULATION_SIZE; i++) population.push_back(Agent());
-    currentBatch = 0;
-    globalGenCounter = 0;
-    gensCalculatedInThisBatch = 0;
+// Escolhe a partida da geração que acabou de ser gravada: de preferência uma que o campeão
+// começou, senão outra dele, senão a primeira. Partidas do cache não têm jogadas e ficam de fora.
+MiniMatch ReplayFromLog(const GameLog& log, int genID) {
+    MiniMatch m;
+    m.game.clear();
+    m.pieces[0] = m.pieces[1] = 0;
+    m.shown = 0; m.genID = genID;
+    m.timer = (float)(rand() % 100) / 100.0f;
+    GameBlock block;
+    GameEntry e;
+    if (!ReadGameBlock(log.lastBlock(), log.lastBlockSize(), block)) return m;
+    int bestRank = 3;
+    for (size_t pos = 0; bestRank > 0 && NextGame(block, pos, e);) {
+        if (e.record.flags & GAME_CACHED) continue;
+        int rank = e.p1 == block.champion ? 0 : (e.p2 == block.champion ? 1 : 2);
+        if (rank < bestRank) { bestRank = rank; m.game = e.record; }
+    }
+    return m;
 }
 
-// Processo Evolutivo
-Agent EvolveOneGeneration() {
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        population[i].fitness = 0;
-        int matches = 3; // Cada agente joga 3 partidas
-        for (int k = 0; k < matches; k++) {
-            int oppIdx = rand() % POPULATION_SIZE; // Oponente aleatório
-            Board b;
-            int moves = 0; bool over = false; int turn = 1;
-            // Loop da partida de treino
-            while (!over && moves < 30) {
-                int piece = (turn == 1) ? 1 : 2;
-                // Durante o treino, usamos Depth 4 fixo nesta versao para rapidez
-                int col = (turn == 1) ? population[i].minimax(b, 4, -9e9, 9e9, true, 1).first
-                    : population[oppIdx].minimax(b, 4, -9e9, 9e9, true, 2).first;
-
-                if (b.isValid(col)) {
-                    b.drop(col, piece);
-                    if (b.checkWin(piece)) {
-                        // Recompensa e Punição
-                        if (turn == 1) population[i].fitness += 20; else population[i].fitness -= 20;
-                        over = true;
-                    }
-                }
-                if (b.isFull()) over = true;
-                turn = (turn == 1) ? 2 : 1;
-                moves++;
-            }
-        }
-    }
-    // Seleção
-    // Ordena de acordo com a fitness
-    sort(population.begin(), population.end(), [](Agent& a, Agent& b) { return a.fitness > b.fitness; });
-    Agent champion = population[0];
-
-    // Reprodução
-    vector<Agent> newPop;
-    // Elitismo: Mantém os melhores para a próxima geração
-    for (int i = 0; i < 6; i++) newPop.push_back(population[i]);
-    // Preenche o resto da população com filhos
-    while (newPop.size() < POPULATION_SIZE) {
-        // Pais são escolhidos apenas do terço superior da população
-        int p1 = rand() % (POPULATION_SIZE / 3);
-        int p2 = rand() % (POPULATION_SIZE / 3);
-
-        vector<double> childG;
-        // Crossover Uniforme
-        for (int g = 0; g < 4; g++) {
-            double v = (rand() % 2 == 0) ? population[p1].genome[g] : population[p2].genome[g];
-            // Mutação
-            if ((rand() % 100) < (MUTATION_RATE * 100)) v += ((rand() % 100) / 10.0 - 0.5);
-            childG.push_back(v);
-        }
-        newPop.push_back(Agent(childG));
+// Há um checkpoint no disco? (a validação completa fica para LoadCheckpoint)
+bool CheckpointExists() {
+    FILE* f = fopen(CHECKPOINT_PATH, "rb");
+    if (f) fclose(f);
+    return f != nullptr;
+}
+
+// Painel de desempenho ([F3]): taxas do último meio segundo, somadas de todas as threads
+// (busca em segundo plano, torneio e a própria interface)
+struct StatsOverlay {
+    bool visible = false;
+    StatSnapshot last, delta;
+    double lastTime = -1;
+};
+StatsOverlay statsOverlay;
+
+void DrawStatsOverlay(StatsOverlay& o) {
+    if (!o.visible) return;
+    int x = SCREEN_WIDTH - 420, y = 10;
+#if C4_STATS
+    double now = GetTime();
+    if (o.lastTime < 0 || now - o.lastTime >= 0.5) {
+        StatSnapshot s;
+        CollectStats(s);
+        if (o.lastTime >= 0) o.delta = s - o.last;
+        o.last = s; o.lastTime = now;
     }
-    population = newPop; // Substitui a população antiga pela nova
-    return champion;
+    const StatSnapshot& d = o.delta;
+    const StatSnapshot& t = o.last; // Médias por geração: desde a abertura do jogo
+    long long gens = t.calls[TIMER_GENERATION];
+    DrawRectangle(x - 10, y - 5, 420, 140, Fade(BLACK, 0.75f));
+    DrawText(TextFormat("FPS %d   frame %.2f ms", GetFPS(), d.calls[TIMER_FRAME] ? d.ms(TIMER_FRAME) / d.calls[TIMER_FRAME] : 0.0),
+             x, y, 18, WHITE);
+    DrawText(TextFormat("Nos %.0f mil/s   podas %.1f%%", d.perSecond(STAT_NODES) / 1000.0,
+                        d.count[STAT_NODES] ? 100.0 * d.count[STAT_CUTOFFS] / d.count[STAT_NODES] : 0.0), x, y + 22, 18, WHITE);
+    DrawText(TextFormat("Folhas %.0f mil/s   vitorias imediatas %.0f/s", d.perSecond(STAT_LEAF_EVALS) / 1000.0,
+                        d.perSecond(STAT_IMMEDIATE_WINS)), x, y + 44, 18, WHITE);
+    DrawText(TextFormat("TT %.0f mil acertos/s, %.0f mil cortes/s", d.perSecond(STAT_TT_HITS) / 1000.0,
+                        d.perSecond(STAT_TT_CUTOFFS) / 1000.0), x, y + 66, 18, WHITE);
+    DrawText(TextFormat("Geracao (media de %lld): partidas %.0f ms", gens, gens ? t.ms(TIMER_MATCHES) / gens : 0.0),
+             x, y + 88, 18, WHITE);
+    DrawText(TextFormat("  selecao %.2f ms   reproducao %.2f ms", gens ? t.ms(TIMER_SELECTION) / gens : 0.0,
+                        gens ? t.ms(TIMER_REPRODUCTION) / gens : 0.0), x, y + 110, 18, WHITE);
+#else
+    DrawRectangle(x - 10, y - 5, 420, 30, Fade(BLACK, 0.75f));
+    DrawText(TextFormat("FPS %d   (compilado com C4_STATS=0)", GetFPS()), x, y, 18, WHITE);
+#endif
 }
 
 // Função para desenhar os tabuleiros pequenos na tela de replay
 void DrawMiniBoard(MiniMatch& m, int x, int y) {
     DrawRectangle(x, y, MINI_BOARD_W, MINI_BOARD_H + 20, BLACK);
     DrawText(TextFormat("Gen %d", m.genID), x + 5, y + MINI_BOARD_H + 2, 10, WHITE);
-    Color status = m.gameOver ? RED : GREEN;
+    Color status = m.gameOver() ? RED : GREEN;
     DrawCircle(x + MINI_BOARD_W - 10, y + MINI_BOARD_H + 8, 4, status);
     for (int c = 0; c < COLS; c++) {
         for (int r = 0; r < ROWS; r++) {
@@ -359,8 +164,9 @@ void DrawMiniBoard(MiniMatch& m, int x, int y) {
             int py = y + r * MINI_CELL_SIZE;
             DrawRectangle(px, py, MINI_CELL_SIZE, MINI_CELL_SIZE, BLUE_BOARD);
             DrawCircle(px + MINI_CELL_SIZE / 2, py + MINI_CELL_SIZE / 2, MINI_CELL_SIZE / 2 - 2, BG_COLOR);
-            if (m.board.grid[r][c] == 1) DrawCircle(px + MINI_CELL_SIZE / 2, py + MINI_CELL_SIZE / 2, MINI_CELL_SIZE / 2 - 2, RED_P1);
-            if (m.board.grid[r][c] == 2) DrawCircle(px + MINI_CELL_SIZE / 2, py + MINI_CELL_SIZE / 2, MINI_CELL_SIZE / 2 - 2, YEL_P2);
+            uint64_t bit = 1ULL << CellBit(r, c);
+            if (m.pieces[0] & bit) DrawCircle(px + MINI_CELL_SIZE / 2, py + MINI_CELL_SIZE / 2, MINI_CELL_SIZE / 2 - 2, RED_P1);
+            if (m.pieces[1] & bit) DrawCircle(px + MINI_CELL_SIZE / 2, py + MINI_CELL_SIZE / 2, MINI_CELL_SIZE / 2 - 2, YEL_P2);
         }
     }
 }
@@ -376,10 +182,28 @@ int main() {
     int playTurn = 1; bool playOver = false; bool engineThinking = false;
     float engineTimer = 0.0f; int winner = 0;
     float batchResetTimer = 0.0f;
+    // Tabela de Transposição do motor (é limpa automaticamente quando o genoma do campeão muda)
+    TranspositionTable engineTable(ENGINE_TT_MB);
+    // Livro de aberturas (opcional): só vale se foi gerado com o genoma do campeão atual
+    OpeningBook engineBook;
+    engineBook.load(BOOK_PATH);
+    // Solver exato de finais (o cache das soluções vale para qualquer genoma e é mantido entre jogadas)
+    Solver engineSolver;
+    // As buscas rodam numa thread de fundo; o loop de desenho só consulta os resultados
+    SearchWorker engineWorker(ENGINE_THREADS);
+    shared_ptr<SearchJob> engineJob;
+    // Partidas do treino: gravadas no arquivo quando possível; senão, só o último bloco em memória
+    GameLog gameLog;
+    trainingLog = &gameLog;
+    bool hasCheckpoint = CheckpointExists();
+    string menuNotice; // Aviso exibido no menu (ex.: checkpoint inválido)
 
     // Loop Principal
     while (!WindowShouldClose()) {
+        STAT_SCOPE(TIMER_FRAME);
+        STAT_INC(STAT_FRAMES);
         float dt = GetFrameTime(); // Tempo entre frames
+        if (IsKeyPressed(KEY_F3)) statsOverlay.visible = !statsOverlay.visible;
 
         switch (state) {
             // Máquina de Estados Finitos
@@ -408,11 +232,49 @@ int main() {
             // Mostra a opção selecionada
             DrawText("FACIL (Depth 2)", 500, 300, 30, (selectedDifficulty == EASY) ? GREEN : DARKGRAY);
             DrawText("MEDIO (Depth 4)", 500, 350, 30, (selectedDifficulty == MEDIUM) ? GREEN : DARKGRAY);
-            DrawText("DIFICIL (Depth 7)", 500, 400, 30, (selectedDifficulty == HARD) ? GREEN : DARKGRAY);
-            DrawText("IMPOSSIVEL (Depth 9)", 500, 450, 30, (selectedDifficulty == IMPOSSIBLE) ? RED : DARKGRAY);
+            DrawText("DIFICIL (1 s/jogada)", 500, 400, 30, (selectedDifficulty == HARD) ? GREEN : DARKGRAY);
+            DrawText("IMPOSSIVEL (3 s/jogada)", 500, 450, 30, (selectedDifficulty == IMPOSSIBLE) ? RED : DARKGRAY);
             DrawText("Pressione [ENTER] para Iniciar", 380, 550, 20, WHITE);
+            if (hasCheckpoint) {
+                DrawText("[C] Continuar o treino salvo   [J] Jogar contra o campeao salvo", 250, 600, 20, LIGHTGRAY);
+            }
+            if (!menuNotice.empty()) DrawText(menuNotice.c_str(), 380, 650, 20, RED);
+            DrawText("[F3] Painel de desempenho", 20, SCREEN_HEIGHT - 30, 16, DARKGRAY);
+            DrawStatsOverlay(statsOverlay);
             EndDrawing();
-            if (IsKeyPressed(KEY_ENTER)) { InitPopulation(); state = BATCH_CALC; }
+            // Jogadores e campeão vão para o log como índices u16 (um checkpoint carregado com [J]
+            // pode ter deixado uma população maior)
+            if (IsKeyPressed(KEY_ENTER) && evoConfig.populationSize > GAME_LOG_MAX_POPULATION) {
+                menuNotice = "Populacao grande demais para o log de partidas";
+                break;
+            }
+            if (IsKeyPressed(KEY_ENTER)) {
+                gameLog.open(GAMES_PATH, false);
+                InitPopulation();
+                currentBatch = 0; gensCalculatedInThisBatch = 0;
+                state = BATCH_CALC;
+            }
+            // Checkpoint: [C] retoma a evolução no lote seguinte; [J] vai direto para o jogo
+            if (hasCheckpoint && (IsKeyPressed(KEY_C) || IsKeyPressed(KEY_J))) {
+                CheckpointExtras saved;
+                if (!LoadCheckpoint(CHECKPOINT_PATH, saved) || !saved.hasBest) {
+                    menuNotice = "Checkpoint invalido ou incompleto";
+                    break;
+                }
+                if (IsKeyPressed(KEY_C) && evoConfig.populationSize > GAME_LOG_MAX_POPULATION) {
+                    menuNotice = "Populacao grande demais para o log de partidas";
+                    break;
+                }
+                menuNotice.clear();
+                bestOfAllTime = Agent(saved.best);
+                bestOfAllTime.fitness = saved.bestFitness;
+                currentBatch = saved.batch; gensCalculatedInThisBatch = 0;
+                if (IsKeyPressed(KEY_C) && currentBatch < TOTAL_BATCHES) { gameLog.open(GAMES_PATH, true); state = BATCH_CALC; }
+                else {
+                    playBoard.reset(); playOver = false; playTurn = 1; engineThinking = false; winner = 0;
+                    state = GAMEPLAY;
+                }
+            }
             break;
 
             // Estado 2 - Treinamento da AG
@@ -428,24 +290,26 @@ int main() {
             DrawRectangle(300, 400, 600, 40, DARKGRAY);
             DrawRectangle(300, 400, (int)(600 * progress), 40, GREEN);
             DrawText(TextFormat("%d%%", (int)(progress * 100)), 580, 410, 20, WHITE);
+            DrawStatsOverlay(statsOverlay);
             EndDrawing();
 
             // Loop de evolução
-            globalGenCounter++;
             Agent champion = EvolveOneGeneration();
 
-            // Prepara uma partida de exibição com o melhor da geração
-            MiniMatch mm; mm.board.reset(); mm.p1 = champion; mm.p2 = population[1];
-            mm.turn = 1; mm.gameOver = false; mm.genID = globalGenCounter;
-            mm.timer = (float)(rand() % 100) / 100.0f;
-            batchMatches.push_back(mm);
+            // Partida de exibição: uma partida do campeão no torneio desta geração
+            batchMatches.push_back(ReplayFromLog(gameLog, globalGenCounter));
 
             gensCalculatedInThisBatch++;
 
             if (gensCalculatedInThisBatch >= GENERATIONS_PER_BATCH) {
                 // Salva o melhor agente globalmente para jogar contra o humano depois
-                bestOfAllTime = batchMatches.back().p1;
+                bestOfAllTime = champion;
                 gensCalculatedInThisBatch = 0;
+                // Checkpoint com o lote já concluído (a gravação é atômica)
+                CheckpointExtras extras;
+                extras.batch = currentBatch + 1;
+                extras.hasBest = true; extras.best = bestOfAllTime.genome; extras.bestFitness = bestOfAllTime.fitness;
+                if (SaveCheckpoint(CHECKPOINT_PATH, extras)) hasCheckpoint = true;
                 state = BATCH_PLAYBACK;
                 batchResetTimer = 0.0f;
             }
@@ -467,22 +331,16 @@ int main() {
                 int col = i % 5; int row = i / 5;
                 int startX = 50 + col * (MINI_BOARD_W + 20); int startY = 100 + row * (MINI_BOARD_H + 50);
 
-                // Lógica de atualização dos tabuleiros pequenos
-                if (!m.gameOver) {
+                // Lógica de atualização dos tabuleiros pequenos: só decodifica a próxima jogada
+                if (!m.gameOver()) {
                     activeCount++;
                     m.timer += dt;
                     if (m.timer > 0.05f) { // Velocidade da animação
                         m.timer = 0.0f;
-                        int playCol = -1;
-                        // Usa profundidade baixa para a visualização ser rápida
-                        if (m.turn == 1) playCol = m.p1.minimax(m.board, 2, -9e9, 9e9, true, 1).first;
-                        else playCol = m.p2.minimax(m.board, 2, -9e9, 9e9, true, 2).first;
-                        if (m.board.isValid(playCol)) {
-                            m.board.drop(playCol, m.turn);
-                            if (m.board.checkWin(m.turn)) m.gameOver = true;
-                            else if (m.board.isFull()) m.gameOver = true;
-                            else m.turn = (m.turn == 1) ? 2 : 1;
-                        }
+                        int c = m.game.move(m.shown);
+                        int h = PopCount((m.pieces[0] | m.pieces[1]) & ColumnMask(c));
+                        m.pieces[m.shown % 2] |= 1ULL << (c * BB_HEIGHT + h);
+                        m.shown++;
                     }
                 }
                 DrawMiniBoard(m, startX, startY);
@@ -497,6 +355,7 @@ int main() {
                     else { playBoard.reset(); state = GAMEPLAY; } // Vai pro jogo real
                 }
             }
+            DrawStatsOverlay(statsOverlay);
             EndDrawing();
             break;
         }
@@ -524,9 +383,20 @@ int main() {
                 else if (engineThinking) {
                     // Turno da AG
                     engineTimer += dt;
-                    if (engineTimer > 0.1f) { // Pequeno delay para parecer que está pensando
-                        // Usa a dificuldade escolhida e o melhor agente treinado
-                        int col = bestOfAllTime.minimax(playBoard, selectedDifficulty, -9e9, 9e9, true, 2).first;
+                    if (!engineJob && engineTimer > 0.1f) { // Pequeno delay para parecer que está pensando
+                        // Usa a dificuldade escolhida e o melhor agente treinado (em segundo plano)
+                        DifficultyConfig dc = GetDifficultyConfig(selectedDifficulty);
+                        Agent engine = bestOfAllTime;
+                        // FACIL e MEDIO não usam o livro nem o solver: as respostas deles são mais fortes que a busca limitada
+                        if (selectedDifficulty == HARD || selectedDifficulty == IMPOSSIBLE) {
+                            engine.book = &engineBook;
+                            engine.solver = &engineSolver; engine.solverEmpty = ENGINE_SOLVER_EMPTY;
+                        }
+                        engineJob = engineWorker.submit(engine, playBoard, 2, dc.timeMs, dc.maxDepth, &engineTable);
+                    }
+                    if (engineJob && engineJob->ready()) {
+                        int col = engineJob->result.col;
+                        engineJob.reset();
                         if (playBoard.isValid(col)) {
                             playBoard.drop(col, 2);
                             if (playBoard.checkWin(2)) { playOver = true; winner = 2; }
@@ -538,6 +408,13 @@ int main() {
                 }
             }
 
+            // [R] e [M] funcionam a qualquer momento e cancelam a busca em andamento
+            if (IsKeyPressed(KEY_R) || IsKeyPressed(KEY_M)) {
+                if (engineJob) { engineJob->cancel(); engineJob.reset(); }
+                playBoard.reset(); playOver = false; playTurn = 1; engineThinking = false; winner = 0;
+                if (IsKeyPressed(KEY_M)) state = MENU;
+            }
+
             // Desenho do Jogo Principal
             BeginDrawing();
             ClearBackground(BG_COLOR);
@@ -548,14 +425,18 @@ int main() {
             else diff = "IMPOSSIVEL";
 
             DrawText(TextFormat("VOCE vs AG %s", diff), 400, 20, 30, WHITE);
+            // Indicador de "pensando" com a velocidade da busca
+            if (engineJob) {
+                DrawText(TextFormat("AG pensando... %.0f mil nos/s", engineJob->nodesPerSecond() / 1000.0), 20, 60, 20, YEL_P2);
+            }
 
             // Desenha o tabuleiro grande
             int bx = (SCREEN_WIDTH - (COLS * CELL_SIZE)) / 2; int by = 100;
             for (int c = 0; c < COLS; c++) for (int r = 0; r < ROWS; r++) {
                 DrawRectangle(bx + c * CELL_SIZE, by + r * CELL_SIZE, CELL_SIZE, CELL_SIZE, BLUE_BOARD);
                 Color pc = BG_COLOR;
-                if (playBoard.grid[r][c] == 1) pc = RED_P1;
-                if (playBoard.grid[r][c] == 2) pc = YEL_P2;
+                if (playBoard.cell(r, c) == 1) pc = RED_P1;
+                if (playBoard.cell(r, c) == 2) pc = YEL_P2;
                 DrawCircle(bx + c * CELL_SIZE + CELL_SIZE / 2, by + r * CELL_SIZE + CELL_SIZE / 2, CELL_SIZE / 2 - 5, pc);
             }
 
@@ -564,10 +445,9 @@ int main() {
                 DrawRectangle(0, SCREEN_HEIGHT / 2 - 50, SCREEN_WIDTH, 100, Fade(BLACK, 0.8f));
                 const char* t = (winner == 1) ? "VOCE VENCEU!" : (winner == 2 ? "AG VENCEU!" : "EMPATE");
                 DrawText(t, 500, SCREEN_HEIGHT / 2 - 20, 50, (winner == 1 ? RED_P1 : YEL_P2));
-                if (IsKeyPressed(KEY_R)) { playBoard.reset(); playOver = false; playTurn = 1; }
-                if (IsKeyPressed(KEY_M)) { state = MENU; }
                 DrawText("[R] Reiniciar   [M] Menu", 500, SCREEN_HEIGHT / 2 + 40, 20, WHITE);
             }
+            DrawStatsOverlay(statsOverlay);
             EndDrawing();
             break;
         }
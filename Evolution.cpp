@@ -0,0 +1,418 @@
+#include "Evolution.h"
+#include "ThreadPool.h"
+#include "Solver.h"
+#include "Stats.h"
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+EvolutionConfig evoConfig;
+Population population;
+int globalGenCounter = 0;
+
+void Population::clear() {
+    for (auto& v : gene) v.clear();
+    fitness.clear();
+}
+
+void Population::reserve(int n) {
+    for (auto& v : gene) v.reserve(n);
+    fitness.reserve(n);
+}
+
+void Population::push(const Genome& g, double fit) {
+    for (int k = 0; k < GENOME_SIZE; k++) gene[k].push_back(g[k]);
+    fitness.push_back(fit);
+}
+
+Genome Population::genome(int i) const {
+    Genome g;
+    for (int k = 0; k < GENOME_SIZE; k++) g[k] = gene[k][i];
+    return g;
+}
+
+void Population::sortByFitness() {
+    int n = size();
+    order.resize(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] > fitness[b]; });
+    // Aplica a permutação a cada array
+    scratch.resize(n);
+    for (int k = 0; k <= GENOME_SIZE; k++) {
+        vector<double>& v = k < GENOME_SIZE ? gene[k] : fitness;
+        for (int i = 0; i < n; i++) scratch[i] = v[order[i]];
+        v.swap(scratch);
+    }
+}
+
+void Population::swap(Population& other) {
+    for (int k = 0; k < GENOME_SIZE; k++) gene[k].swap(other.gene[k]);
+    fitness.swap(other.fitness);
+}
+
+void SeedEvolution(uint32_t seed) { gen.seed(seed); }
+
+// Reseta a população para o estado inicial
+void InitPopulation() {
+    population.clear();
+    for (int i = 0; i < evoConfig.populationSize; i++) population.push(Agent().genome);
+    globalGenCounter = 0;
+    ResetTournamentCache();
+}
+
+// Pool usado pelo torneio (recriado se evoConfig.threads mudar)
+static ThreadPool& TrainingPool() {
+    static unique_ptr<ThreadPool> pool;
+    int wanted = evoConfig.threads > 0 ? evoConfig.threads : max(1, (int)thread::hardware_concurrency());
+    if (!pool || pool->size() != wanted) pool.reset(new ThreadPool(wanted));
+    return *pool;
+}
+
+// Semente de uma partida do torneio: mistura a semente da geração com (agente, partida).
+// Não depende de qual thread joga a partida, então o resultado é o mesmo para qualquer número de threads.
+static uint32_t MatchSeed(uint64_t genSeed, int agent, int match) {
+    uint64_t s = genSeed ^ ((uint64_t)agent << 32) ^ (uint64_t)match;
+    return (uint32_t)SplitMix64(s);
+}
+
+// Cache de aberturas (vale entre gerações; ver OpeningCache)
+static OpeningCache openingCache;
+
+// Jogada de um agente numa partida de treino. Nas primeiras OPENING_PLIES jogadas, a busca é
+// feita na orientação canônica da posição e a coluna vai para o cache de aberturas: a mesma
+// posição, ou o seu espelho, em outra partida (desta geração ou das seguintes) sai do cache.
+template<class B> static int TrainingMove(B& b, Agent& agent, uint64_t genomeKey, int depth, int piece) {
+    if constexpr (B::SYMMETRIC) {
+        if (b.moveCount() < OPENING_PLIES) {
+            uint64_t k = b.key(), m = b.mirroredKey();
+            bool flip = m < k;
+            uint64_t key = OpeningKey(genomeKey, flip ? m : k, depth, evoConfig.board);
+            int col;
+            if (openingCache.probe(key, col)) STAT_INC(STAT_OPENING_HITS);
+            else {
+                if (flip) {
+                    B mirror;
+                    mirror.mirrorFrom(b);
+                    col = agent.minimax(mirror, depth, -9e9, 9e9, true, piece).first;
+                }
+                else col = agent.minimax(b, depth, -9e9, 9e9, true, piece).first;
+                openingCache.store(key, col);
+            }
+            return flip && col >= 0 ? B::COLS - 1 - col : col;
+        }
+    }
+    return agent.minimax(b, depth, -9e9, 9e9, true, piece).first;
+}
+
+// Final pequeno: o Solver dá o resultado com jogo perfeito (vencedor em winner) e encerra a partida
+template<class B> static bool Adjudicate(const B& b, int piece, int& winner) {
+    if constexpr (is_same<B, Board>::value) {
+        if (evoConfig.adjudicateEmpty > 0 && ROWS * COLS - b.moveCount() <= evoConfig.adjudicateEmpty) {
+            static thread_local unique_ptr<Solver> solver;
+            if (!solver) solver.reset(new Solver(18));
+            int value = solver->solve(b);
+            winner = value > 0 ? piece : (value < 0 ? 3 - piece : 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Partida de treino num tabuleiro B (uma instância por tamanho; ver WithBoard)
+template<class B> static int PlayTrainingGameOn(B& b, Agent& p1, Agent& p2, int depth, GameRecord* record) {
+    int moves = 0; bool over = false; int turn = 1; int winner = 0;
+    if (record) record->clear();
+    uint64_t key1 = GenomeHash(p1.genome.data(), GENOME_SIZE), key2 = GenomeHash(p2.genome.data(), GENOME_SIZE);
+    // Loop da partida de treino
+    while (!over && moves < 30) {
+        int piece = (turn == 1) ? 1 : 2;
+        if (Adjudicate(b, piece, winner)) {
+            if (record) record->flags = GAME_ADJUDICATED;
+            break;
+        }
+        int col = (turn == 1) ? TrainingMove(b, p1, key1, depth, 1) : TrainingMove(b, p2, key2, depth, 2);
+
+        if (b.isValid(col)) {
+            b.drop(col, piece);
+            if (record) record->push(col);
+            if (b.checkWin(piece)) { winner = piece; over = true; }
+        }
+        if (b.isFull()) over = true;
+        turn = (turn == 1) ? 2 : 1;
+        moves++;
+    }
+    if (record) record->winner = (uint8_t)winner;
+    return winner;
+}
+
+// Joga uma partida de treino e devolve o vencedor (1 ou 2; 0 = empate ou limite de jogadas)
+int PlayTrainingGame(Agent& p1, Agent& p2, int depth, GameRecord* record) {
+    return WithBoard(evoConfig.board, [&](auto b) { return PlayTrainingGameOn(b, p1, p2, depth, record); });
+}
+
+// Estado das partidas de um lote, em arrays contíguos (um conjunto por thread e por tamanho de
+// tabuleiro, reaproveitado: sem alocação depois do primeiro lote)
+template<class B> struct GameBatchState {
+    std::vector<B> boards;
+    std::vector<Agent> agents;        // P1 e P2 de cada partida: 2 * k e 2 * k + 1
+    std::vector<uint64_t> genomeKeys; // GenomeHash dos mesmos agentes
+    std::vector<int> live, cols, moves;
+};
+
+// As mesmas partidas de PlayTrainingGameOn, avançadas juntas: cada volta do laço leva todas as
+// partidas ainda ativas pela adjudicação, pela escolha da jogada (com as folhas em lote) e pela
+// jogada com o teste de fim, e tira da lista as que acabaram. A sequência de jogadas de cada
+// partida é a mesma do laço de uma partida só, então vencedor e registro também são.
+template<class B> static void PlayTrainingGamesOn(const Pairing* pairings, const int* games, int count, int depth,
+                                                  int* winners, GameRecord* records) {
+    static thread_local GameBatchState<B> st;
+    st.boards.resize(count);
+    st.agents.clear(); st.genomeKeys.clear(); st.live.clear();
+    st.cols.resize(count); st.moves.assign(count, 0);
+    for (int k = 0; k < count; k++) {
+        const Pairing& pr = pairings[games[k]];
+        st.boards[k].reset();
+        for (int i : { pr.p1, pr.p2 }) {
+            st.agents.push_back(population.agent(i));
+            st.agents.back().batchLeaves = true;
+            st.genomeKeys.push_back(GenomeHash(st.agents.back().genome.data(), GENOME_SIZE));
+        }
+        winners[games[k]] = 0;
+        if (records) records[games[k]].clear();
+        st.live.push_back(k);
+    }
+    while (!st.live.empty()) {
+        // Fase 1: adjudicação e escolha da jogada de cada partida ativa
+        int kept = 0;
+        for (int k : st.live) {
+            B& b = st.boards[k];
+            int piece = st.moves[k] % 2 + 1;
+            if (Adjudicate(b, piece, winners[games[k]])) {
+                if (records) records[games[k]].flags = GAME_ADJUDICATED;
+                continue;
+            }
+            st.cols[k] = TrainingMove(b, st.agents[2 * k + piece - 1], st.genomeKeys[2 * k + piece - 1], depth, piece);
+            st.live[kept++] = k;
+        }
+        st.live.resize(kept);
+        // Fase 2: jogada, vitória, tabuleiro cheio e limite de jogadas
+        kept = 0;
+        for (int k : st.live) {
+            B& b = st.boards[k];
+            int piece = st.moves[k] % 2 + 1, col = st.cols[k];
+            bool over = false;
+            if (b.isValid(col)) {
+                b.drop(col, piece);
+                if (records) records[games[k]].push(col);
+                if (b.checkWin(piece)) { winners[games[k]] = piece; over = true; }
+            }
+            if (b.isFull()) over = true;
+            if (!over && ++st.moves[k] < 30) st.live[kept++] = k;
+        }
+        st.live.resize(kept);
+    }
+    if (records) for (int k = 0; k < count; k++) records[games[k]].winner = (uint8_t)winners[games[k]];
+}
+
+void PlayTrainingGames(const Pairing* pairings, const int* games, int count, int depth, int* winners, GameRecord* records) {
+    WithBoard(evoConfig.board, [&](auto b) { PlayTrainingGamesOn<decltype(b)>(pairings, games, count, depth, winners, records); });
+}
+
+// Cache de resultados do torneio (vale entre gerações e entre agendas; ver MatchCache)
+static MatchCache matchCache;
+TournamentStats tournamentStats;
+GameLog* trainingLog = nullptr;
+
+// Joga as partidas que ainda não estão no cache e devolve o vencedor de cada uma.
+// As partidas são divididas em lotes (PlayTrainingGames), quatro por thread para equilibrar a
+// carga; cada lote é uma tarefa do pool e grava os próprios resultados (sem disputa entre threads).
+static void PlayPairings(const vector<Pairing>& pairings, vector<int>& winners, int depth) {
+    static vector<uint64_t> keys;
+    static vector<int> pending;
+    static vector<GameRecord> records;
+    int n = (int)pairings.size();
+    winners.assign(n, 0);
+    keys.resize(n);
+    if (trainingLog) records.resize(n);
+    pending.clear();
+    for (int t = 0; t < n; t++) {
+        keys[t] = MatchKey(population.genome(pairings[t].p1), population.genome(pairings[t].p2),
+                           depth, evoConfig.adjudicateEmpty, evoConfig.board, OPENING_PLIES);
+        if (!matchCache.probe(keys[t], winners[t])) pending.push_back(t);
+    }
+    ThreadPool& pool = TrainingPool();
+    int games = (int)pending.size(), batches = min(games, 4 * pool.size());
+    pool.parallelFor(batches, [&](int task, int) {
+        int begin = (int)((long long)games * task / batches), end = (int)((long long)games * (task + 1) / batches);
+        // Durante o treino, usamos uma profundidade menor (Depth 4 por padrão) para rapidez
+        PlayTrainingGames(pairings.data(), pending.data() + begin, end - begin, depth, winners.data(),
+                          trainingLog ? records.data() : nullptr);
+    });
+    for (int t : pending) matchCache.store(keys[t], winners[t]);
+    if (trainingLog) {
+        // Partidas do cache entram sem jogadas (são iguais a uma já gravada); a ordem é a das
+        // partidas, então o log não depende do número de threads
+        for (int t = 0, next = 0; t < n; t++) {
+            if (next < (int)pending.size() && pending[next] == t) next++;
+            else { records[t].clear(); records[t].winner = (uint8_t)winners[t]; records[t].flags = GAME_CACHED; }
+            trainingLog->add(pairings[t].p1, pairings[t].p2, records[t]);
+        }
+    }
+    tournamentStats.games += pending.size();
+    tournamentStats.cached += n - (int)pending.size();
+    STAT_ADD(STAT_GAMES, pending.size());
+    STAT_ADD(STAT_CACHED_GAMES, n - pending.size());
+}
+
+// Corrida: cada etapa joga com os melhores da anterior, mais fundo (ver RacingStages). Cada
+// participante começa matchesPerAgent partidas contra outros participantes sorteados, e os pontos
+// (+20 vitória, -20 derrota, só para quem começou) se acumulam entre as etapas. A fitness é
+// etapa alcançada * (mais que qualquer soma de pontos) + pontos: quem caiu antes fica abaixo.
+static void RunRacing(uint64_t genSeed) {
+    const int popSize = population.size();
+    const int matches = evoConfig.matchesPerAgent;
+    static vector<Pairing> pairings;
+    static vector<int> winners, alive;
+    static vector<double> points;
+    RacingStage stages[3];
+    int count = RacingStages(popSize, evoConfig.trainingDepth, min(evoConfig.eliteCount, popSize), max(1, popSize / 3), stages);
+    const double stageBonus = 40.0 * matches * count + 1;
+
+    points.assign(popSize, 0);
+    alive.resize(popSize);
+    for (int i = 0; i < popSize; i++) alive[i] = i;
+    for (int s = 0; s < count; s++) {
+        // Os `agents` melhores até aqui (empates: índice menor primeiro)
+        sort(alive.begin(), alive.end(), [&](int a, int b) { return points[a] != points[b] ? points[a] > points[b] : a < b; });
+        int n = stages[s].agents;
+        alive.resize(n);
+        sort(alive.begin(), alive.end());
+        pairings.clear();
+        for (int k = 0; k < n; k++)
+            for (int m = 0; m < matches; m++) {
+                mt19937 rng(MatchSeed(genSeed, alive[k], s * matches + m));
+                int o = rng() % (n - 1); // Oponente: outro participante
+                pairings.push_back({ alive[k], alive[o < k ? o : o + 1] });
+            }
+        PlayPairings(pairings, winners, stages[s].depth);
+        for (size_t t = 0; t < pairings.size(); t++) {
+            if (winners[t] == 1) points[pairings[t].p1] += 20; else if (winners[t] == 2) points[pairings[t].p1] -= 20;
+        }
+        for (int i : alive) population.fitness[i] = s * stageBonus + points[i]; // A etapa 0 tem todos
+    }
+}
+
+void ResetTournamentCache() {
+    matchCache.clear();
+    openingCache.clear();
+    tournamentStats = TournamentStats();
+}
+
+// Torneio da geração: grava a fitness de cada indivíduo
+void RunTournament() {
+    const int popSize = population.size();
+    const int matches = evoConfig.matchesPerAgent; // Cada agente joga 3 partidas (padrão)
+    // Buffers estáticos: depois da primeira geração, o treino não aloca memória
+    static vector<Pairing> pairings;
+    static vector<int> winners;
+    static vector<GameResult> results;
+    uint64_t genSeed = ((uint64_t)gen() << 32) | gen();
+
+    if (evoConfig.schedule == SCHEDULE_RANDOM) {
+        pairings.clear();
+        for (int i = 0; i < popSize; i++)
+            for (int k = 0; k < matches; k++) {
+                mt19937 rng(MatchSeed(genSeed, i, k));
+                pairings.push_back({ i, (int)(rng() % popSize) }); // Oponente aleatório
+            }
+        PlayPairings(pairings, winners, evoConfig.trainingDepth);
+        // Recompensa e Punição (só o agente i, que começou a partida, pontua)
+        for (int i = 0; i < popSize; i++) {
+            population.fitness[i] = 0;
+            for (int k = 0; k < matches; k++) {
+                int winner = winners[i * matches + k];
+                if (winner == 1) population.fitness[i] += 20; else if (winner == 2) population.fitness[i] -= 20;
+            }
+        }
+    }
+    else if (evoConfig.schedule == SCHEDULE_RACING) RunRacing(genSeed);
+    else {
+        // Round-robin e suíço: a fitness é o rating Elo calculado com todas as partidas da geração
+        results.clear();
+        auto collect = [&] {
+            for (size_t t = 0; t < pairings.size(); t++)
+                results.push_back({ pairings[t].p1, pairings[t].p2, winners[t] == 1 ? 1.0 : (winners[t] == 2 ? 0.0 : 0.5) });
+        };
+        if (evoConfig.schedule == SCHEDULE_ROUND_ROBIN) {
+            static vector<uint64_t> ids;
+            ids.resize(popSize);
+            for (int i = 0; i < popSize; i++) ids[i] = GenomeHash(population.genome(i).data(), GENOME_SIZE);
+            RoundRobinPairings(popSize, ids.data(), pairings);
+            PlayPairings(pairings, winners, evoConfig.trainingDepth);
+            collect();
+        }
+        else {
+            static SwissSystem swiss;
+            swiss.reset(popSize);
+            for (int round = 0; round < matches; round++) {
+                swiss.pair(round, pairings);
+                PlayPairings(pairings, winners, evoConfig.trainingDepth);
+                size_t first = results.size();
+                collect();
+                for (size_t t = first; t < results.size(); t++) swiss.record(results[t]);
+            }
+        }
+        EloRatings(popSize, results, population.fitness.data());
+    }
+}
+
+// Processo Evolutivo
+Agent EvolveOneGeneration() {
+    STAT_SCOPE(TIMER_GENERATION);
+    STAT_INC(STAT_GENERATIONS);
+    const int popSize = population.size();
+    if (trainingLog) trainingLog->beginGeneration(globalGenCounter + 1, evoConfig.board);
+    {
+        STAT_SCOPE(TIMER_MATCHES);
+        RunTournament();
+    }
+    globalGenCounter++;
+
+    // Seleção
+    // Ordena de acordo com a fitness
+    {
+        STAT_SCOPE(TIMER_SELECTION);
+        population.sortByFitness();
+    }
+    if (trainingLog && !trainingLog->endGeneration(population.sortedFrom(0))) trainingLog->close(); // Disco cheio: para de gravar
+    Agent champion = population.agent(0);
+
+    // Reprodução
+    STAT_SCOPE(TIMER_REPRODUCTION);
+    static Population newPop;
+    newPop.clear();
+    newPop.reserve(popSize);
+    // Elitismo: Mantém os melhores para a próxima geração
+    for (int i = 0; i < min(evoConfig.eliteCount, popSize); i++) newPop.push(population.genome(i), population.fitness[i]);
+    // Preenche o resto da população com filhos
+    int parents = max(1, popSize / 3);
+    while ((int)newPop.size() < popSize) {
+        // Pais são escolhidos apenas do terço superior da população
+        int p1 = gen() % parents;
+        int p2 = gen() % parents;
+
+        Genome childG;
+        // Crossover Uniforme
+        for (int g = 0; g < GENOME_SIZE; g++) {
+            double v = (gen() % 2 == 0) ? population.gene[g][p1] : population.gene[g][p2];
+            // Mutação
+            if ((gen() % 100) < (evoConfig.mutationRate * 100)) v += ((gen() % 100) / 10.0 - 0.5);
+            childG[g] = v;
+        }
+        newPop.push(childG);
+    }
+    population.swap(newPop); // Substitui a população antiga pela nova (troca os buffers, sem copiar)
+    return champion;
+}
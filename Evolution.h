@@ -0,0 +1,100 @@
+#pragma once
+// Processo evolutivo (população, torneio, seleção e reprodução).
+// Não depende da raylib: é usado pela interface e pelo connect4-train.
+#include "Agent.h"
+#include "GameLog.h"
+#include "Tournament.h"
+#include <vector>
+#include <cstdint>
+
+// Genética (valores padrão)
+const int POPULATION_SIZE = 50;
+const double MUTATION_RATE = 0.20;
+// Jogadas iniciais de cada partida de treino buscadas na orientação canônica e guardadas no
+// cache de aberturas (só nos tabuleiros simétricos). É fixo, e não um campo de EvolutionConfig,
+// porque muda o resultado das partidas e não vai no checkpoint; entra na MatchKey mesmo assim
+const int OPENING_PLIES = 8;
+// Maior --adjudicate aceito: com mais casas vazias, o Solver exato em toda partida trava o treino
+const int MAX_ADJUDICATE_EMPTY = 20;
+
+// Parâmetros da evolução (podem ser alterados antes de InitPopulation/EvolveOneGeneration)
+struct EvolutionConfig {
+    int populationSize = POPULATION_SIZE;
+    int trainingDepth = 4;       // Profundidade do Minimax nas partidas de treino
+    int matchesPerAgent = 3;     // Partidas de cada agente por geração (rodadas, no suíço)
+    TournamentSchedule schedule = SCHEDULE_RANDOM; // Quem joga contra quem (ver Tournament.h)
+    int eliteCount = 6;          // Melhores que passam inalterados para a próxima geração
+    double mutationRate = MUTATION_RATE;
+    int threads = 0;             // Threads usadas no torneio (0 = uma por núcleo da máquina)
+    int adjudicateEmpty = 0;     // Com tantas casas vazias ou menos, o Solver decide a partida (0 = desligado)
+    BoardVariant board = BOARD_6X7; // Tamanho do tabuleiro das partidas de treino (ver Board.h)
+};
+extern EvolutionConfig evoConfig;
+
+// População guardada como estrutura de arrays: o gene g de todos os indivíduos fica contíguo
+// em gene[g] e as fitness em fitness. Os agentes (genoma + pesos + tabelas de ordenação)
+// só são montados na hora de jogar, com agent(i).
+struct Population {
+    std::vector<double> gene[GENOME_SIZE];
+    std::vector<double> fitness;
+
+    int size() const { return (int)fitness.size(); }
+    void clear();
+    void reserve(int n);
+    void push(const Genome& g, double fit = 0);
+    Genome genome(int i) const;
+    Agent agent(int i) const { Agent a(genome(i)); a.fitness = fitness[i]; return a; }
+
+    // Ordena por fitness decrescente. Permuta os índices com o mesmo std::sort que ordenava
+    // o antigo vector<Agent>, então empates ficam na mesma ordem (treino reproduzível).
+    void sortByFitness();
+    // Posição que o i-ésimo colocado tinha antes do último sortByFitness (índice no torneio)
+    int sortedFrom(int i) const { return order[i]; }
+    void swap(Population& other);
+
+private:
+    std::vector<int> order;      // Buffers do sortByFitness (reaproveitados: sem alocação depois da
+    std::vector<double> scratch; // primeira geração)
+};
+
+extern Population population;
+extern int globalGenCounter; // Gerações já evoluídas desde o último InitPopulation
+
+// Partidas do torneio desde o último InitPopulation: jogadas e reaproveitadas do cache
+struct TournamentStats { long long games = 0, cached = 0; };
+extern TournamentStats tournamentStats;
+
+// Log das partidas de treino (nullptr = desligado). Com ele, cada geração grava um bloco com
+// todas as partidas do torneio, na ordem das partidas, e o índice do campeão.
+extern GameLog* trainingLog;
+
+// Reinicia o fluxo mestre de números aleatórios (treino reproduzível)
+void SeedEvolution(uint32_t seed);
+
+// Reseta a população para o estado inicial
+void InitPopulation();
+
+// Joga uma partida de treino e devolve o vencedor (1 ou 2; 0 = empate ou limite de jogadas).
+// Com evoConfig.adjudicateEmpty > 0, a partida termina assim que o resultado exato é conhecido
+// (só no tabuleiro padrão, o único que o Solver conhece). O tamanho vem de evoConfig.board.
+// Com record, as jogadas, o vencedor e as flags da partida são gravados nele.
+int PlayTrainingGame(Agent& p1, Agent& p2, int depth, GameRecord* record = nullptr);
+
+// Joga várias partidas de treino juntas (lockstep): as partidas t = games[0..count) de pairings,
+// com os agentes da população. Os tabuleiros ficam num array contíguo, um único laço leva todas
+// pela escolha da jogada, jogada e teste de fim, e as buscas pontuam as folhas em lote
+// (Agent::batchLeaves). winners[t] (e records[t], se não for nullptr) saem iguais aos de
+// PlayTrainingGame(population.agent(p1), population.agent(p2), depth).
+void PlayTrainingGames(const Pairing* pairings, const int* games, int count, int depth, int* winners,
+                       GameRecord* records = nullptr);
+
+// Torneio de uma geração (agenda evoConfig.schedule): grava a fitness de cada indivíduo.
+// Com SCHEDULE_RANDOM a fitness são os pontos das partidas (+20 vitória, -20 derrota);
+// nas outras agendas é o rating Elo (ver EloRatings).
+void RunTournament();
+
+// Esvazia o cache de resultados e zera tournamentStats (InitPopulation já faz isso)
+void ResetTournamentCache();
+
+// Evolui uma geração e devolve o campeão (melhor fitness) dela
+Agent EvolveOneGeneration();
@@ -0,0 +1,265 @@
+#include "GameLog.h"
+#include "BinaryIO.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+#if defined(__unix__) || defined(__APPLE__)
+#define C4_GAME_LOG_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char GAME_LOG_MAGIC[4] = { 'C', '4', 'G', 'L' };
+static const size_t GAME_LOG_CHUNK = 1 << 20; // O arquivo mapeado cresce de 1 MB em diante, dobrando
+
+static void StoreU64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+static void StoreU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+
+static void MakeHeader(uint8_t* h, uint64_t used) {
+    memcpy(h, GAME_LOG_MAGIC, 4);
+    StoreU32(h + 4, GAME_LOG_VERSION);
+    StoreU64(h + 8, used);
+}
+
+// Confere o cabeçalho e devolve os bytes válidos (0 se não for um log desta versão)
+static uint64_t CheckHeader(const uint8_t* h, uint64_t fileSize) {
+    ByteReader r{ h + 4, GAME_LOG_HEADER - 4 };
+    if (memcmp(h, GAME_LOG_MAGIC, 4) != 0 || r.u32() != GAME_LOG_VERSION) return 0;
+    uint64_t used = r.u64();
+    return used >= (uint64_t)GAME_LOG_HEADER && used <= fileSize ? used : 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Gravação
+
+void GameLog::beginGeneration(int generation, BoardVariant board) {
+    block.clear();
+    PutU32(block, (uint32_t)generation);
+    PutU32(block, 0); PutU32(block, 0); PutU16(block, 0); // Partidas, bytes e campeão: no endGeneration
+    block.push_back((uint8_t)board);
+    block.push_back(0);
+    blockGames = 0;
+    closedSize = 0;
+}
+
+void GameLog::add(int p1, int p2, const GameRecord& r) {
+    PutU16(block, (uint16_t)p1); PutU16(block, (uint16_t)p2);
+    block.push_back(r.count);
+    block.push_back((uint8_t)(r.winner | r.flags << 2));
+    for (int j = 0; j < r.bytes(); j++) block.push_back((uint8_t)(r.bits[j >> 3] >> ((j & 7) * 8)));
+    blockGames++;
+}
+
+bool GameLog::endGeneration(int champion) {
+    StoreU32(&block[4], (uint32_t)blockGames);
+    StoreU32(&block[8], (uint32_t)(block.size() - GAME_BLOCK_HEADER));
+    block[12] = (uint8_t)champion; block[13] = (uint8_t)(champion >> 8);
+    closedSize = block.size();
+    totalGames += blockGames;
+    return !isOpen() || writeBlock();
+}
+
+#ifdef C4_GAME_LOG_MMAP
+
+bool GameLog::isOpen() const { return fd >= 0; }
+
+// Aumenta o arquivo para `bytes` bytes com blocos de verdade no disco. Com ftruncate o arquivo
+// ficaria esparso, e escrever no mapeamento com o disco cheio mataria o processo (SIGBUS);
+// assim o disco cheio aparece aqui, como falha (ENOSPC)
+static bool AllocateFile(int fd, size_t bytes) {
+#ifdef __APPLE__
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)bytes, 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        if (fcntl(fd, F_PREALLOCATE, &store) == -1) return false;
+    }
+    return ftruncate(fd, (off_t)bytes) == 0;
+#else
+    return posix_fallocate(fd, 0, (off_t)bytes) == 0;
+#endif
+}
+
+// Garante o arquivo mapeado com pelo menos `bytes` bytes
+bool GameLog::reserve(size_t bytes) {
+    if (map && bytes <= capacity) return true;
+    size_t grown = max(capacity, GAME_LOG_CHUNK);
+    while (grown < bytes) grown *= 2;
+    if (map) munmap(map, capacity);
+    map = nullptr;
+    if (!AllocateFile(fd, grown)) return false;
+    void* p = mmap(nullptr, grown, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    map = (uint8_t*)p; capacity = grown;
+    return true;
+}
+
+bool GameLog::open(const string& path, bool append) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | (append ? 0 : O_TRUNC), 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    uint8_t header[GAME_LOG_HEADER];
+    used = GAME_LOG_HEADER;
+    bool ok = fstat(fd, &st) == 0;
+    // Continua depois do último bloco completo (o resto do arquivo é sobrescrito)
+    if (ok && st.st_size > 0) {
+        ok = pread(fd, header, GAME_LOG_HEADER, 0) == GAME_LOG_HEADER && (used = CheckHeader(header, st.st_size)) != 0;
+    }
+    if (ok) ok = reserve(max((size_t)st.st_size, used));
+    if (!ok) { ::close(fd); fd = -1; return false; }
+    MakeHeader(map, used);
+    return true;
+}
+
+bool GameLog::writeBlock() {
+    if (!reserve(used + closedSize)) return false;
+    memcpy(map + used, block.data(), closedSize);
+    used += closedSize;
+    StoreU64(map + 8, used); // Só depois dos dados: o bloco passa a valer inteiro
+    return true;
+}
+
+void GameLog::close() {
+    if (fd < 0) return;
+    if (map) munmap(map, capacity);
+    if (ftruncate(fd, (off_t)used) != 0) {} // Sobra depois de used é ignorada pelos leitores
+    ::close(fd);
+    fd = -1; map = nullptr; capacity = 0;
+}
+
+#else
+
+// Sem mmap: o bloco vai para o fim do arquivo com fwrite
+bool GameLog::isOpen() const { return file != nullptr; }
+bool GameLog::reserve(size_t) { return true; }
+
+bool GameLog::open(const string& path, bool append) {
+    close();
+    FILE* f = append ? fopen(path.c_str(), "r+b") : nullptr;
+    uint8_t header[GAME_LOG_HEADER];
+    used = GAME_LOG_HEADER;
+    if (f) {
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (size > 0 && (fread(header, 1, GAME_LOG_HEADER, f) != GAME_LOG_HEADER || (used = CheckHeader(header, size)) == 0)) {
+            fclose(f); return false;
+        }
+    }
+    else if (!(f = fopen(path.c_str(), "w+b"))) return false;
+    MakeHeader(header, used);
+    if (fseek(f, 0, SEEK_SET) != 0 || fwrite(header, 1, GAME_LOG_HEADER, f) != GAME_LOG_HEADER) { fclose(f); return false; }
+    file = f;
+    return true;
+}
+
+bool GameLog::writeBlock() {
+    FILE* f = (FILE*)file;
+    uint8_t header[GAME_LOG_HEADER];
+    if (fseek(f, (long)used, SEEK_SET) != 0 || fwrite(block.data(), 1, closedSize, f) != closedSize) return false;
+    used += closedSize;
+    MakeHeader(header, used);
+    return fseek(f, 0, SEEK_SET) == 0 && fwrite(header, 1, GAME_LOG_HEADER, f) == GAME_LOG_HEADER && fflush(f) == 0;
+}
+
+void GameLog::close() {
+    if (file) fclose((FILE*)file);
+    file = nullptr;
+}
+
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// Leitura
+
+#ifdef C4_GAME_LOG_MMAP
+
+bool GameLogFile::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= GAME_LOG_HEADER)
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // O mapeamento continua valendo sem o descritor
+    if (p == MAP_FAILED) return false;
+    mapped = (size_t)st.st_size;
+    bytes = (const uint8_t*)p;
+    madvise(p, mapped, MADV_SEQUENTIAL);
+    length = (size_t)CheckHeader(bytes, mapped);
+    if (length == 0) { close(); return false; }
+    return true;
+}
+
+void GameLogFile::close() {
+    if (mapped) munmap((void*)bytes, mapped);
+    bytes = nullptr; length = mapped = 0;
+}
+
+#else
+
+bool GameLogFile::open(const string& path) {
+    close();
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    copy.resize(size > 0 ? (size_t)size : 0);
+    bool ok = size >= GAME_LOG_HEADER && fread(copy.data(), 1, copy.size(), f) == copy.size();
+    fclose(f);
+    if (ok) length = (size_t)CheckHeader(copy.data(), copy.size());
+    if (!ok || length == 0) { close(); return false; }
+    bytes = copy.data();
+    return true;
+}
+
+void GameLogFile::close() {
+    copy.clear();
+    bytes = nullptr; length = mapped = 0;
+}
+
+#endif
+
+bool ReadGameBlock(const uint8_t* data, size_t size, GameBlock& out) {
+    ByteReader r{ data, size };
+    out.generation = r.i32();
+    out.games = r.i32();
+    out.bytes = r.u32();
+    out.champion = r.u16();
+    uint8_t board = r.u8();
+    r.u8();
+    if (!r.ok || out.bytes > r.left || board >= NUM_BOARD_VARIANTS) return false;
+    out.board = (BoardVariant)board;
+    out.data = data + GAME_BLOCK_HEADER;
+    return true;
+}
+
+bool NextGameBlock(const uint8_t* data, size_t size, size_t& offset, GameBlock& out) {
+    if (offset >= size || !ReadGameBlock(data + offset, size - offset, out)) return false;
+    offset += GAME_BLOCK_HEADER + out.bytes;
+    return true;
+}
+
+bool NextGame(const GameBlock& block, size_t& offset, GameEntry& out) {
+    if (offset >= block.bytes) return false;
+    const uint8_t* p = block.data + offset;
+    size_t left = block.bytes - offset;
+    if (left < (size_t)GAME_RECORD_HEADER) return false;
+    GameRecord& r = out.record;
+    r.clear();
+    out.p1 = p[0] | p[1] << 8;
+    out.p2 = p[2] | p[3] << 8;
+    r.count = p[4];
+    r.winner = p[5] & 3; r.flags = p[5] >> 2;
+    int n = r.bytes();
+    if (r.count > 64 || (size_t)(GAME_RECORD_HEADER + n) > left) return false;
+    for (int j = 0; j < n; j++) r.bits[j >> 3] |= (uint64_t)p[GAME_RECORD_HEADER + j] << ((j & 7) * 8);
+    offset += GAME_RECORD_HEADER + n;
+    return true;
+}
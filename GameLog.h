@@ -0,0 +1,128 @@
+#pragma once
+// Log das partidas de treino: cada partida é a sequência de colunas, 3 bits por jogada, com
+// um cabeçalho de 6 bytes (uma partida de 30 jogadas ocupa 18 bytes). As partidas de uma geração
+// formam um bloco, acrescentado ao fim do arquivo de uma vez só. No POSIX o arquivo fica mapeado
+// em memória (mmap) e cresce em pedaços, então acrescentar um bloco é uma cópia de memória.
+// O replay da interface e o connect4-games só decodificam jogadas, sem buscar nada.
+#include "Board.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato (little-endian, BinaryIO.h):
+//   Cabeçalho: "C4GL", versão (u32), bytes válidos do arquivo (u64, atualizado a cada bloco)
+//   Bloco:     geração (u32), partidas (u32), bytes das partidas (u32), campeão da geração
+//              (u16, índice no torneio), tabuleiro (u8, BoardVariant), reservado (u8)
+//   Partida:   P1 e P2 (u16, índices no torneio), jogadas (u8), vencedor | flags << 2 (u8) e as
+//              colunas, 3 bits cada, a partir do bit menos significativo do primeiro byte
+// Um arquivo interrompido no meio de um bloco continua válido até o último bloco completo.
+const uint32_t GAME_LOG_VERSION = 1;
+const int GAME_LOG_HEADER = 16, GAME_BLOCK_HEADER = 16, GAME_RECORD_HEADER = 6;
+// Jogadores e campeão são índices u16: populações maiores não cabem no log
+const int GAME_LOG_MAX_POPULATION = 65535;
+
+enum GameFlags {
+    GAME_ADJUDICATED = 1, // Encerrada pelo Solver (evoConfig.adjudicateEmpty)
+    GAME_CACHED = 2       // Resultado do cache do torneio: a partida não foi jogada de novo e vem sem jogadas
+};
+
+// Jogadas de uma partida, 3 bits cada (colunas 0 a 7), até 64 jogadas
+struct GameRecord {
+    uint64_t bits[3];
+    uint8_t count, winner, flags;
+
+    void clear() { bits[0] = bits[1] = bits[2] = 0; count = winner = flags = 0; }
+    void push(int col) {
+        int i = count * 3, w = i >> 6, s = i & 63;
+        bits[w] |= (uint64_t)col << s;
+        if (s > 61) bits[w + 1] |= (uint64_t)col >> (64 - s); // Coluna dividida entre duas palavras
+        count++;
+    }
+    int move(int k) const {
+        int i = k * 3, w = i >> 6, s = i & 63;
+        uint64_t v = bits[w] >> s;
+        if (s > 61) v |= bits[w + 1] << (64 - s);
+        return (int)(v & 7);
+    }
+    int bytes() const { return (count * 3 + 7) / 8; }
+};
+static_assert(Board7x8::COLS <= 8 && Board7x8::ROWS * Board7x8::COLS <= 64, "3 bits por coluna e até 64 jogadas");
+
+// Uma partida lida de um bloco
+struct GameEntry { int p1, p2; GameRecord record; };
+
+// Cabeçalho de um bloco lido; data aponta para as partidas
+struct GameBlock {
+    int generation = 0, games = 0, champion = 0;
+    BoardVariant board = BOARD_6X7;
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+};
+
+// Gravação. Sem arquivo aberto, os blocos só ficam em memória (lastBlock), como na interface
+// quando o log não pode ser criado.
+class GameLog {
+public:
+    GameLog() = default;
+    GameLog(const GameLog&) = delete;
+    GameLog& operator=(const GameLog&) = delete;
+    ~GameLog() { close(); }
+
+    // Cria o arquivo (ou continua um log existente com append); false se não for possível
+    bool open(const std::string& path, bool append);
+    void close();
+    bool isOpen() const;
+
+    // Uma geração: beginGeneration, add para cada partida (na ordem do torneio), endGeneration
+    void beginGeneration(int generation, BoardVariant board);
+    void add(int p1, int p2, const GameRecord& r);
+    bool endGeneration(int champion); // false se o bloco não pôde ser gravado no arquivo
+
+    // Último bloco completo (cabeçalho incluído), válido até o próximo beginGeneration
+    const uint8_t* lastBlock() const { return block.data(); }
+    size_t lastBlockSize() const { return closedSize; }
+    long long games() const { return totalGames; }
+
+private:
+    std::vector<uint8_t> block;
+    size_t closedSize = 0;
+    int blockGames = 0;
+    long long totalGames = 0;
+    bool writeBlock();
+
+    // Arquivo
+    int fd = -1;
+    uint8_t* map = nullptr;
+    size_t capacity = 0, used = 0;
+    void* file = nullptr; // FILE* nos sistemas sem mmap
+    bool reserve(size_t bytes);
+};
+
+// Leitura de um log inteiro (mapeado só para leitura no POSIX)
+class GameLogFile {
+public:
+    GameLogFile() = default;
+    GameLogFile(const GameLogFile&) = delete;
+    GameLogFile& operator=(const GameLogFile&) = delete;
+    ~GameLogFile() { close(); }
+
+    bool open(const std::string& path); // Confere o cabeçalho; false se não for um log válido
+    void close();
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0, mapped = 0;
+    std::vector<uint8_t> copy; // Sistemas sem mmap: o arquivo inteiro em memória
+};
+
+// Percorre os blocos de um log (data/size de GameLogFile) a partir de *offset, que começa em
+// GAME_LOG_HEADER. Devolve false no fim ou num bloco corrompido.
+bool NextGameBlock(const uint8_t* data, size_t size, size_t& offset, GameBlock& out);
+
+// Lê o bloco que começa em data (como lastBlock)
+bool ReadGameBlock(const uint8_t* data, size_t size, GameBlock& out);
+
+// Percorre as partidas de um bloco a partir de *offset (começa em 0)
+bool NextGame(const GameBlock& block, size_t& offset, GameEntry& out);
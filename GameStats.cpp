@@ -0,0 +1,126 @@
+// connect4-games: estatísticas de um log de partidas do treino (GameLog.h), com saída em JSON.
+// Só decodifica jogadas (3 bits cada), então milhões de partidas levam poucos segundos.
+// Uso: connect4-games [--log arquivo] [--from G] [--to G] [--verify]
+#include "GameLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+using namespace std;
+
+static void PrintUsage() {
+    printf("Uso: connect4-games [opcoes]\n"
+           "  --log ARQUIVO  Log gravado pelo connect4-train --games (padrao connect4.games)\n"
+           "  --from G       Primeira geracao considerada (padrao: todas)\n"
+           "  --to G         Ultima geracao considerada\n"
+           "  --verify       Refaz cada partida no tabuleiro e confere jogadas e resultado\n"
+           "                 (codigo de saida 1 se alguma partida nao bater)\n");
+}
+
+// Refaz a partida: todas as jogadas válidas, nenhuma depois de uma vitória, e o vencedor gravado
+// igual ao do tabuleiro (partidas decididas pelo Solver terminam sem ninguém alinhado)
+template<class B> static bool ReplayGame(B b, const GameRecord& r) {
+    int piece = 1;
+    for (int k = 0; k < r.count; k++) {
+        int c = r.move(k);
+        if (!b.isValid(c) || b.checkWin(3 - piece)) return false;
+        b.drop(c, piece);
+        piece = 3 - piece;
+    }
+    int last = 3 - piece;
+    bool won = r.count > 0 && b.checkWin(last);
+    if (r.flags & GAME_ADJUDICATED) return !won;
+    if (r.winner != 0) return won && r.winner == last;
+    return r.count > 0 && !won;
+}
+
+int main(int argc, char** argv) {
+    const char* logPath = "connect4.games";
+    int from = 0, to = 1 << 30;
+    bool verify = false;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) { PrintUsage(); return 0; }
+        else if (!strcmp(arg, "--log") && hasValue) logPath = argv[++i];
+        else if (!strcmp(arg, "--from") && hasValue) from = atoi(argv[++i]);
+        else if (!strcmp(arg, "--to") && hasValue) to = atoi(argv[++i]);
+        else if (!strcmp(arg, "--verify")) verify = true;
+        else { fprintf(stderr, "Argumento invalido: %s\n", arg); PrintUsage(); return 1; }
+    }
+
+    GameLogFile file;
+    if (!file.open(logPath)) { fprintf(stderr, "Log invalido: %s\n", logPath); return 1; }
+
+    // Casas de cada tamanho de tabuleiro (partida que enche o tabuleiro = empate de verdade)
+    int cells[NUM_BOARD_VARIANTS];
+    for (int v = 0; v < NUM_BOARD_VARIANTS; v++)
+        cells[v] = WithBoard((BoardVariant)v, [](auto b) { return decltype(b)::ROWS * decltype(b)::COLS; });
+
+    long long blocks = 0, games = 0, cached = 0, adjudicated = 0, moves = 0, mismatches = 0;
+    long long p1Wins = 0, p2Wins = 0, draws = 0, unfinished = 0;
+    long long championGames = 0, championPoints2 = 0; // Pontos do campeão da geração em dobro (empate = 1)
+    long long firstMove[8] = {}, lengths[65] = {};
+    int firstGen = -1, lastGen = -1, minLength = 64, maxLength = 0;
+    bool corrupt = false;
+
+    auto t0 = chrono::steady_clock::now();
+    size_t offset = GAME_LOG_HEADER;
+    GameBlock block;
+    GameEntry e;
+    while (offset < file.size()) {
+        if (!NextGameBlock(file.data(), file.size(), offset, block)) { corrupt = true; break; }
+        if (block.generation < from || block.generation > to) continue;
+        if (firstGen < 0) firstGen = block.generation;
+        lastGen = block.generation;
+        blocks++;
+        int count = 0;
+        for (size_t pos = 0; NextGame(block, pos, e); count++) {
+            const GameRecord& r = e.record;
+            games++;
+            if (r.winner == 1) p1Wins++; else if (r.winner == 2) p2Wins++;
+            if (e.p1 == block.champion || e.p2 == block.champion) {
+                int side = e.p1 == block.champion ? 1 : 2;
+                championGames++;
+                championPoints2 += r.winner == side ? 2 : (r.winner == 0 ? 1 : 0);
+            }
+            if (r.flags & GAME_CACHED) { cached++; continue; }
+            if (r.flags & GAME_ADJUDICATED) adjudicated++;
+            else if (r.winner == 0) { if (r.count == cells[block.board]) draws++; else unfinished++; }
+            moves += r.count;
+            lengths[r.count]++;
+            minLength = min(minLength, (int)r.count); maxLength = max(maxLength, (int)r.count);
+            if (r.count > 0) firstMove[r.move(0)]++;
+            if (verify && !WithBoard(block.board, [&](auto b) { return ReplayGame(b, r); })) mismatches++;
+        }
+        if (count != block.games) corrupt = true;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    long long played = games - cached;
+    printf("{\n  \"log\": \"%s\",\n  \"bytes\": %zu,\n  \"generations\": %lld,\n  \"first_generation\": %d,\n"
+           "  \"last_generation\": %d,\n  \"games\": %lld,\n  \"played\": %lld,\n  \"cached\": %lld,\n  \"adjudicated\": %lld,\n",
+           logPath, file.size(), blocks, firstGen, lastGen, games, played, cached, adjudicated);
+    printf("  \"results\": {\"p1_wins\": %lld, \"p2_wins\": %lld, \"draws\": %lld, \"move_limit\": %lld},\n",
+           p1Wins, p2Wins, draws, unfinished);
+    printf("  \"champion\": {\"games\": %lld, \"score\": %.4f},\n", championGames,
+           championGames ? championPoints2 / (2.0 * championGames) : 0.0);
+    printf("  \"length\": {\"average\": %.2f, \"min\": %d, \"max\": %d, \"histogram\": {", played ? (double)moves / played : 0.0,
+           played ? minLength : 0, maxLength);
+    bool first = true;
+    for (int n = 0; n <= 64; n++) {
+        if (!lengths[n]) continue;
+        printf("%s\"%d\": %lld", first ? "" : ", ", n, lengths[n]);
+        first = false;
+    }
+    printf("}},\n  \"first_move\": [");
+    for (int c = 0; c < 8; c++) printf("%s%lld", c ? ", " : "", firstMove[c]);
+    printf("],\n  \"bits_per_move\": %.2f,\n  \"seconds\": %.3f,\n  \"games_per_sec\": %.0f,\n", moves ? file.size() * 8.0 / moves : 0.0,
+           seconds, seconds > 0 ? games / seconds : 0.0);
+    if (verify) printf("  \"verify_mismatches\": %lld,\n", mismatches);
+    bool ok = !corrupt && mismatches == 0;
+    printf("  \"ok\": %s\n}\n", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+#include "Island.h"
+#include "BinaryIO.h"
+#include <algorithm>
+
+using namespace std;
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL; // Vizinho morto: erro no send em vez de SIGPIPE
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// Mensagens: tamanho (u32) + dados em little-endian (BinaryIO.h)
+
+static bool WriteAll(int fd, const uint8_t* p, size_t n) {
+    while (n > 0) {
+        ssize_t k = send(fd, p, n, SEND_FLAGS);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k; n -= k;
+    }
+    return true;
+}
+
+static bool ReadAll(int fd, uint8_t* p, size_t n) {
+    while (n > 0) {
+        ssize_t k = read(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false; // 0: o outro lado fechou (processo terminou)
+        p += k; n -= k;
+    }
+    return true;
+}
+
+static bool SendMessage(int fd, const vector<uint8_t>& msg) {
+    uint8_t size[4];
+    for (int i = 0; i < 4; i++) size[i] = (uint8_t)(msg.size() >> (8 * i));
+    return WriteAll(fd, size, 4) && WriteAll(fd, msg.data(), msg.size());
+}
+
+static bool ReceiveMessage(int fd, vector<uint8_t>& msg) {
+    uint8_t size[4];
+    if (!ReadAll(fd, size, 4)) return false;
+    uint32_t n = size[0] | size[1] << 8 | size[2] << 16 | (uint32_t)size[3] << 24;
+    if (n > (1u << 24)) return false;
+    msg.resize(n);
+    return ReadAll(fd, msg.data(), n);
+}
+
+static void PutGenome(vector<uint8_t>& out, const Genome& g) { for (double v : g) PutF64(out, v); }
+static Genome ReadGenome(ByteReader& r) { Genome g; for (double& v : g) v = r.f64(); return g; }
+
+// Relatório: ilha, geração, campeão, fitness, partidas, cache e os migrantes
+static void EncodeReport(vector<uint8_t>& out, const IslandReport& rep, const vector<Genome>& migrants) {
+    out.clear();
+    PutU32(out, rep.island); PutU32(out, rep.generation);
+    PutGenome(out, rep.champion); PutF64(out, rep.fitness);
+    PutU64(out, rep.games); PutU64(out, rep.cached);
+    PutU32(out, (uint32_t)migrants.size());
+    for (const Genome& g : migrants) PutGenome(out, g);
+}
+
+static bool DecodeReport(const vector<uint8_t>& in, IslandReport& rep, vector<Genome>& migrants) {
+    ByteReader r{ in.data(), in.size() };
+    rep.island = r.i32(); rep.generation = r.i32();
+    rep.champion = ReadGenome(r); rep.fitness = r.f64();
+    rep.games = (long long)r.u64(); rep.cached = (long long)r.u64();
+    uint32_t n = r.u32();
+    if (!r.ok || n > r.left / (8 * GENOME_SIZE)) return false;
+    migrants.resize(n);
+    for (Genome& g : migrants) g = ReadGenome(r);
+    return r.ok && r.left == 0;
+}
+
+static void EncodeMigrants(vector<uint8_t>& out, const vector<Genome>& migrants) {
+    out.clear();
+    PutU32(out, (uint32_t)migrants.size());
+    for (const Genome& g : migrants) PutGenome(out, g);
+}
+
+static bool DecodeMigrants(const vector<uint8_t>& in, vector<Genome>& migrants) {
+    ByteReader r{ in.data(), in.size() };
+    uint32_t n = r.u32();
+    if (!r.ok || n > r.left / (8 * GENOME_SIZE)) return false;
+    migrants.resize(n);
+    for (Genome& g : migrants) g = ReadGenome(r);
+    return r.ok && r.left == 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Trabalhador
+
+static uint32_t IslandSeed(uint32_t seed, int island) {
+    if (island == 0) return seed;
+    uint64_t s = (uint64_t)seed << 32 | (uint64_t)island;
+    return (uint32_t)SplitMix64(s);
+}
+
+// Núcleos em que o processo pode rodar (o coordenador divide esta lista entre as ilhas)
+static vector<int> AllowedCores() {
+    vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; c++) if (CPU_ISSET(c, &set)) cores.push_back(c);
+#endif
+    if (cores.empty()) for (int c = 0; c < max(1, (int)thread::hardware_concurrency()); c++) cores.push_back(c);
+    return cores;
+}
+
+// Evolui a ilha e conversa com o coordenador; devolve o código de saída do processo
+static int IslandWorker(const IslandConfig& cfg, int island, int fd, const vector<int>& cores) {
+    // A ilha fica com a fatia [island * c / N, (island + 1) * c / N) dos núcleos
+    int c = (int)cores.size(), first = island * c / cfg.islands, last = (island + 1) * c / cfg.islands;
+#ifdef __linux__
+    if (cfg.pinCores && last > first) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int k = first; k < last; k++) CPU_SET(cores[k], &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+    if (evoConfig.threads <= 0) evoConfig.threads = max(1, last - first);
+    SeedEvolution(IslandSeed(cfg.seed, island));
+    InitPopulation();
+
+    int sendCount = min({ cfg.migrants, evoConfig.eliteCount, population.size() / 2 });
+    vector<Genome> migrants;
+    vector<uint8_t> msg;
+    IslandReport rep;
+    rep.island = island;
+    while (globalGenCounter < cfg.generations) {
+        Agent champion = EvolveOneGeneration();
+        bool done = globalGenCounter == cfg.generations;
+        if (globalGenCounter % cfg.migrateEvery != 0 && !done) continue;
+
+        // A elite (os melhores do torneio, já ordenados) fica no começo da nova população
+        rep.generation = globalGenCounter;
+        rep.champion = champion.genome; rep.fitness = champion.fitness;
+        rep.games = tournamentStats.games; rep.cached = tournamentStats.cached;
+        migrants.resize(sendCount);
+        for (int k = 0; k < sendCount; k++) migrants[k] = population.genome(k);
+        EncodeReport(msg, rep, migrants);
+        if (!SendMessage(fd, msg)) return 1;
+        if (done) break;
+
+        // Os migrantes da vizinha entram no lugar dos últimos filhos (ainda sem torneio)
+        if (!ReceiveMessage(fd, msg) || !DecodeMigrants(msg, migrants)) return 1;
+        int n = min((int)migrants.size(), population.size() / 2);
+        for (int k = 0; k < n; k++) {
+            int i = population.size() - 1 - k;
+            for (int g = 0; g < GENOME_SIZE; g++) population.gene[g][i] = migrants[k][g];
+            population.fitness[i] = 0;
+        }
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Coordenador
+
+// Round-robin de ida e volta entre os campeões: vitória 1 ponto, empate meio
+static int PickGlobalChampion(const vector<IslandReport>& finals) {
+    int n = (int)finals.size();
+    vector<double> points(n, 0);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            if (i == j) continue;
+            Agent p1(finals[i].champion), p2(finals[j].champion);
+            int winner = PlayTrainingGame(p1, p2, evoConfig.trainingDepth);
+            if (winner == 1) points[i] += 1; else if (winner == 2) points[j] += 1;
+            else { points[i] += 0.5; points[j] += 0.5; }
+        }
+    int best = 0;
+    for (int i = 1; i < n; i++) if (points[i] > points[best]) best = i;
+    return best;
+}
+
+bool RunIslands(const IslandConfig& cfg, void (*onReport)(const IslandReport&), IslandResult& result) {
+    if (cfg.islands < 1 || cfg.generations < 1 || cfg.migrateEvery < 1 || cfg.migrants < 0) return false;
+    vector<int> cores = AllowedCores();
+    vector<int> fds(cfg.islands, -1);
+    vector<pid_t> pids(cfg.islands, -1);
+    // Sem isso, o que estiver no buffer do stdio seria impresso de novo por cada filho
+    fflush(stdout); fflush(stderr);
+
+    bool ok = true;
+    for (int i = 0; i < cfg.islands && ok; i++) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) { ok = false; break; }
+        pid_t pid = fork();
+        if (pid < 0) { close(sv[0]); close(sv[1]); ok = false; break; }
+        if (pid == 0) {
+            // Filho: só fica com a sua ponta; _exit não roda destrutores nem esvazia buffers do pai
+            close(sv[0]);
+            for (int k = 0; k < i; k++) close(fds[k]);
+            _exit(IslandWorker(cfg, i, sv[1], cores));
+        }
+        close(sv[1]);
+        fds[i] = sv[0]; pids[i] = pid;
+    }
+
+    // Épocas: recebe o relatório de todas as ilhas, na ordem, e repassa os migrantes em anel
+    vector<IslandReport> reports(cfg.islands);
+    vector<vector<Genome>> migrants(cfg.islands);
+    vector<uint8_t> msg;
+    for (int generation = 0; ok && generation < cfg.generations;) {
+        generation = min(cfg.generations, generation + cfg.migrateEvery);
+        for (int i = 0; i < cfg.islands && ok; i++) {
+            ok = ReceiveMessage(fds[i], msg) && DecodeReport(msg, reports[i], migrants[i]) &&
+                 reports[i].island == i && reports[i].generation == generation;
+            if (ok && onReport) onReport(reports[i]);
+        }
+        if (!ok || generation == cfg.generations) break;
+        for (int i = 0; i < cfg.islands && ok; i++) {
+            // Com uma ilha só não há vizinha: ela recebe uma lista vazia e segue sozinha
+            EncodeMigrants(msg, cfg.islands > 1 ? migrants[(i + cfg.islands - 1) % cfg.islands] : vector<Genome>());
+            ok = SendMessage(fds[i], msg);
+        }
+    }
+
+    // Erro: derruba as ilhas que ainda estiverem rodando
+    for (int i = 0; i < cfg.islands; i++) {
+        if (fds[i] < 0) continue;
+        if (!ok) kill(pids[i], SIGKILL);
+        close(fds[i]);
+        int status = 0;
+        while (waitpid(pids[i], &status, 0) < 0 && errno == EINTR) {}
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    if (!ok) return false;
+
+    result.games = result.cached = 0;
+    for (const IslandReport& r : reports) { result.games += r.games; result.cached += r.cached; }
+    result.championIsland = PickGlobalChampion(reports);
+    result.champion = Agent(reports[result.championIsland].champion);
+    result.champion.fitness = reports[result.championIsland].fitness;
+    return true;
+}
+
+#else
+
+bool RunIslands(const IslandConfig&, void (*)(const IslandReport&), IslandResult&) { return false; }
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+// Modelo de ilhas: N processos trabalhadores (fork) evoluem cada um a sua própria população com
+// EvolveOneGeneration e, a cada K gerações, mandam os melhores indivíduos ao coordenador (o
+// processo que chamou RunIslands), que os repassa em anel: a ilha i recebe os migrantes da
+// ilha i-1 no lugar dos seus piores filhos. A troca usa sockets Unix locais (socketpair).
+// Cada ilha tem a memória do seu processo e, no Linux, uma fatia própria dos núcleos.
+// Só em sistemas POSIX; nos outros, RunIslands devolve false.
+#include "Evolution.h"
+#include <cstdint>
+
+struct IslandConfig {
+    int islands = 4;          // Processos trabalhadores
+    int generations = 50;     // Gerações de cada ilha
+    int migrateEvery = 5;     // Gerações entre migrações (K)
+    int migrants = 2;         // Melhores de cada ilha enviados à vizinha (no máximo evoConfig.eliteCount)
+    uint32_t seed = 0;        // A ilha 0 usa esta semente (uma ilha só = treino normal); as outras, derivadas dela
+    bool pinCores = true;     // Prende cada ilha a uma fatia dos núcleos permitidos (só Linux)
+};
+
+// Relatório de uma ilha ao fim de cada época (a cada migrateEvery gerações e na última)
+struct IslandReport {
+    int island = 0, generation = 0;
+    Genome champion = {};     // Campeão da última geração da ilha
+    double fitness = 0;
+    long long games = 0, cached = 0; // Partidas da ilha até aqui (tournamentStats do processo)
+};
+
+struct IslandResult {
+    Agent champion;           // Campeão global
+    int championIsland = -1;
+    long long games = 0, cached = 0; // Somados de todas as ilhas
+};
+
+// Roda o treino em ilhas com evoConfig (populationSize é o tamanho de CADA ilha; com
+// evoConfig.threads = 0, cada ilha usa a sua fatia dos núcleos). Os relatórios chegam em
+// onReport (opcional) no processo coordenador, em ordem de época e de ilha, então a saída é
+// a mesma a cada execução. O campeão global sai de um round-robin de ida e volta entre os
+// campeões finais das ilhas (empate: a ilha de menor índice).
+// Deve ser chamada antes de o processo criar threads: fork só copia a thread que chama.
+bool RunIslands(const IslandConfig& cfg, void (*onReport)(const IslandReport&), IslandResult& result);
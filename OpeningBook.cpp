@@ -0,0 +1,134 @@
+#include "OpeningBook.h"
+#include "BinaryIO.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
+using namespace std;
+
+static const char BOOK_MAGIC[4] = { 'C', '4', 'B', 'K' };
+static const uint64_t KEY_MASK = (1ULL << 56) - 1;
+
+uint64_t OpeningBook::canonicalKey(const Board& b, bool& mirrored) {
+    uint64_t k = b.key(), m = b.mirroredKey();
+    mirrored = m < k;
+    return mirrored ? m : k;
+}
+
+int OpeningBook::probe(const Board& b) const {
+    if (entries.empty() || b.moveCount() >= maxPly) return -1;
+    bool mirrored;
+    uint64_t key = canonicalKey(b, mirrored);
+    auto it = lower_bound(entries.begin(), entries.end(), key, [](uint64_t e, uint64_t k) { return (e & KEY_MASK) < k; });
+    if (it == entries.end() || (*it & KEY_MASK) != key) return -1;
+    int col = (int)(*it >> COL_SHIFT);
+    if (mirrored) col = COLS - 1 - col;
+    return b.isValid(col) ? col : -1;
+}
+
+bool OpeningBook::save(const string& path) const {
+    vector<uint8_t> out(BOOK_MAGIC, BOOK_MAGIC + 4);
+    PutU32(out, BOOK_VERSION);
+    PutU64(out, genomeKey);
+    PutU32(out, (uint32_t)maxPly);
+    PutU32(out, (uint32_t)searchDepth);
+    PutU32(out, (uint32_t)entries.size());
+    for (uint64_t e : entries) PutU64(out, e);
+    return WriteFileAtomic(path, out);
+}
+
+bool OpeningBook::load(const string& path) {
+    vector<uint8_t> data;
+    if (!ReadFileChecked(path, data)) return false;
+    if (data.size() < 8 || memcmp(data.data(), BOOK_MAGIC, 4) != 0) return false;
+    ByteReader r{ data.data() + 4, data.size() - 4 };
+    if (r.u32() != BOOK_VERSION) return false;
+    uint64_t key = r.u64();
+    int ply = r.i32(), depth = r.i32();
+    uint32_t count = r.u32();
+    if (!r.ok || (size_t)count * 8 != r.left) return false;
+    vector<uint64_t> e(count);
+    for (uint64_t& v : e) v = r.u64();
+    if (!is_sorted(e.begin(), e.end(), [](uint64_t a, uint64_t b) { return (a & KEY_MASK) < (b & KEY_MASK); })) return false;
+    entries.swap(e);
+    genomeKey = key; maxPly = ply; searchDepth = depth;
+    return true;
+}
+
+// Sequência de jogadas a partir do tabuleiro vazio (o Board é reconstruído ao jogá-la,
+// com a avaliação incremental em dia)
+struct BookLine {
+    int8_t col[ROWS * COLS];
+    int n = 0;
+    void replay(Board& b) const {
+        b.reset();
+        for (int i = 0; i < n; i++) b.drop(col[i], i % 2 == 0 ? 1 : 2);
+    }
+};
+
+void OpeningBook::build(const Genome& genome, int plies, int depth, int side, int threads) {
+    entries.clear();
+    genomeKey = GenomeHash(genome.data(), GENOME_SIZE);
+    maxPly = plies; searchDepth = depth;
+
+    ThreadPool pool(threads);
+    // Cada worker tem o próprio agente e a própria tabela (limpa a cada posição, para que
+    // o resultado não dependa de qual thread analisou o quê)
+    vector<Agent> agents(pool.size(), Agent(genome));
+    vector<unique_ptr<TranspositionTable>> tables;
+    for (int w = 0; w < pool.size(); w++) {
+        tables.emplace_back(new TranspositionTable(4));
+        agents[w].attachTable(tables[w].get());
+    }
+
+    for (int bookSide = 1; bookSide <= 2; bookSide++) {
+        if (side != 0 && side != bookSide) continue;
+        vector<BookLine> level(1); // Começa do tabuleiro vazio
+        for (int ply = 0; ply < plies && !level.empty(); ply++) {
+            int toMove = ply % 2 == 0 ? 1 : 2;
+            vector<int> reply(level.size(), -1);
+            if (toMove == bookSide) {
+                // Posições do lado do livro: busca em paralelo
+                pool.parallelFor((int)level.size(), [&](int task, int worker) {
+                    Board b;
+                    level[task].replay(b);
+                    Agent& a = agents[worker];
+                    tables[worker]->clear();
+                    reply[task] = a.minimax(b, depth, -9e9, 9e9, true, toMove).first;
+                });
+                for (size_t i = 0; i < level.size(); i++) {
+                    Board b;
+                    level[i].replay(b);
+                    bool mirrored;
+                    uint64_t key = canonicalKey(b, mirrored);
+                    int col = mirrored ? COLS - 1 - reply[i] : reply[i];
+                    if (reply[i] >= 0) entries.push_back(key | ((uint64_t)col << COL_SHIFT));
+                }
+            }
+            // Próximo nível: jogada do livro (lado do livro) ou todas as jogadas (oponente),
+            // sem posições terminais e sem repetir posições (nem espelhadas)
+            vector<BookLine> next;
+            unordered_set<uint64_t> seen;
+            for (size_t i = 0; i < level.size(); i++) {
+                Board b;
+                level[i].replay(b);
+                for (int c = 0; c < COLS; c++) {
+                    if (toMove == bookSide ? c != reply[i] : !b.isValid(c)) continue;
+                    b.drop(c, toMove);
+                    bool mirrored;
+                    if (!b.checkWin(toMove) && !b.isFull() && seen.insert(canonicalKey(b, mirrored)).second) {
+                        BookLine line = level[i];
+                        line.col[line.n++] = (int8_t)c;
+                        next.push_back(line);
+                    }
+                    b.undoMove(c);
+                }
+            }
+            level.swap(next);
+        }
+    }
+    sort(entries.begin(), entries.end(), [](uint64_t a, uint64_t b) { return (a & KEY_MASK) < (b & KEY_MASK); });
+    entries.erase(unique(entries.begin(), entries.end(), [](uint64_t a, uint64_t b) { return (a & KEY_MASK) == (b & KEY_MASK); }),
+                  entries.end());
+}
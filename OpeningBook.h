@@ -0,0 +1,39 @@
+#pragma once
+// Livro de aberturas: respostas pré-calculadas para as primeiras jogadas, quando a árvore
+// do Minimax é mais larga e a busca mais cara. Gerado offline (connect4-book) com o
+// avaliador treinado e consultado pelo Agent::think antes de buscar.
+#include "Agent.h"
+#include <string>
+#include <vector>
+
+const uint32_t BOOK_VERSION = 1;
+
+class OpeningBook {
+public:
+    uint64_t genomeKey = 0; // GenomeHash do genoma usado na geração (o livro só vale para ele)
+    int maxPly = 0;         // Posições com menos de maxPly pedras
+    int searchDepth = 0;    // Profundidade do Minimax usada em cada posição
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+
+    // Coluna do livro para a posição (-1 se ela não estiver no livro)
+    int probe(const Board& b) const;
+
+    // Formato: "C4BK" + versão + cabeçalho + entradas de 8 bytes (BinaryIO.h)
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Gera o livro para as posições em que o lado `side` (1, 2 ou 0 = ambos) joga, até maxPly pedras.
+    // O lado do livro segue a jogada escolhida; o oponente tenta todas. Posições espelhadas
+    // são analisadas uma vez só. As buscas rodam em paralelo (threads <= 0: uma por núcleo).
+    void build(const Genome& genome, int maxPly, int depth, int side, int threads);
+
+private:
+    // Chave canônica (a menor entre a posição e o seu espelho) nos 56 bits baixos e a
+    // coluna nos 8 bits altos, ordenadas pela chave para busca binária
+    static const int COL_SHIFT = 56;
+    std::vector<uint64_t> entries;
+
+    static uint64_t canonicalKey(const Board& b, bool& mirrored);
+};
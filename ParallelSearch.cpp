@@ -0,0 +1,35 @@
+#include "ParallelSearch.h"
+#include <atomic>
+
+using namespace std;
+
+Agent::SearchResult LazySmpThink(ThreadPool& pool, Agent& master, const Board& board, int piece, int timeMs, int maxDepth) {
+    if (pool.size() <= 1) {
+        Board b = board;
+        return master.think(b, piece, timeMs, maxDepth);
+    }
+    atomic<bool> stop(false);
+    atomic<long long> helperNodes(0);
+    Agent::SearchResult result = { -1, 0, 0, 0, 0 };
+    // Uma tarefa por worker: a tarefa 0 roda na thread que chamou (o worker 0 do pool)
+    pool.parallelFor(pool.size(), [&](int task, int) {
+        Board b = board;
+        if (task == 0) {
+            result = master.think(b, piece, timeMs, maxDepth);
+            stop.store(true, memory_order_relaxed); // Auxiliares param quando a principal termina
+            return;
+        }
+        Agent helper = master;
+        helper.cancelFlag = &stop;
+        helper.liveNodes = nullptr;
+        helper.book = nullptr;
+        helper.solver = nullptr;
+        // Metade das auxiliares começa uma profundidade à frente: as threads se espalham
+        // por iterações diferentes em vez de repetirem a mesma busca
+        helper.startDepth = 1 + task % 2;
+        helper.think(b, piece, timeMs, maxDepth);
+        helperNodes.fetch_add(helper.nodes, memory_order_relaxed);
+    });
+    result.nodes += helperNodes.load();
+    return result;
+}
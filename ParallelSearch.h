@@ -0,0 +1,11 @@
+#pragma once
+// Busca paralela Lazy SMP: várias threads fazem o Aprofundamento Iterativo na mesma posição,
+// compartilhando a Tabela de Transposição (sem locks). As auxiliares começam em profundidades
+// diferentes e enchem a tabela com resultados que a thread principal reaproveita.
+#include "Agent.h"
+#include "ThreadPool.h"
+
+// A thread principal é o próprio `master` (com tabela, livro, solver, cancelamento etc. já
+// configurados) e o resultado é o dele, com a mesma semântica do think() de uma thread só.
+// result.nodes soma os nós de todas as threads. Com pool.size() == 1, é só master.think().
+Agent::SearchResult LazySmpThink(ThreadPool& pool, Agent& master, const Board& board, int piece, int timeMs, int maxDepth);
@@ -0,0 +1,84 @@
+#include "SearchWorker.h"
+#include "ParallelSearch.h"
+
+using namespace std;
+
+double SearchJob::nodesPerSecond() const {
+    if (ready()) return result.ms > 0 ? result.nodes * 1000.0 / result.ms : 0;
+    if (!running.load(memory_order_acquire)) return 0;
+    double s = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return s > 0 ? liveNodes.load(memory_order_relaxed) / s : 0;
+}
+
+SearchWorker::SearchWorker(int threads) : pool(threads), thread(&SearchWorker::loop, this) {}
+
+SearchWorker::~SearchWorker() {
+    cancelAll();
+    { lock_guard<mutex> lk(m); quit = true; }
+    cv.notify_all();
+    thread.join();
+}
+
+shared_ptr<SearchJob> SearchWorker::submit(const Agent& agent, const Board& board, int piece,
+                                           int timeMs, int depth, TranspositionTable* table) {
+    shared_ptr<SearchJob> job = make_shared<SearchJob>();
+    job->agent = agent;
+    job->board = board;
+    job->piece = piece;
+    job->timeMs = timeMs;
+    job->depth = depth;
+    job->table = table;
+    { lock_guard<mutex> lk(m); queue.push_back(job); }
+    cv.notify_one();
+    return job;
+}
+
+void SearchWorker::cancelAll() {
+    lock_guard<mutex> lk(m);
+    for (auto& job : queue) { job->cancel(); job->done.store(true, memory_order_release); }
+    queue.clear();
+    if (current) current->cancel();
+}
+
+void SearchWorker::loop() {
+    for (;;) {
+        shared_ptr<SearchJob> job;
+        {
+            unique_lock<mutex> lk(m);
+            cv.wait(lk, [&] { return quit || !queue.empty(); });
+            if (quit) return;
+            job = queue.front();
+            queue.pop_front();
+            current = job;
+        }
+        execute(*job);
+        lock_guard<mutex> lk(m);
+        current.reset();
+    }
+}
+
+void SearchWorker::execute(SearchJob& job) {
+    Agent& a = job.agent;
+    a.cancelFlag = &job.canceled;
+    a.liveNodes = &job.liveNodes;
+    // A tabela é ligada aqui (e não na thread da interface) porque trocar de genoma a limpa
+    a.attachTable(job.table);
+    if (job.table) job.table->newSearch();
+
+    job.started = chrono::steady_clock::now();
+    job.running.store(true, memory_order_release);
+    if (!job.canceled.load(memory_order_relaxed)) {
+        if (job.timeMs > 0) {
+            job.result = LazySmpThink(pool, a, job.board, job.piece, job.timeMs, job.depth);
+        }
+        else {
+            a.nodes = 0; a.cutoffs = 0; a.stopSearch = false;
+            pair<int, double> r = a.minimax(job.board, job.depth, -9e9, 9e9, true, job.piece);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - job.started).count();
+            job.result = { a.stopSearch ? -1 : r.first, r.second, job.depth, a.nodes, ms };
+        }
+    }
+    job.liveNodes.store(a.nodes, memory_order_relaxed);
+    job.running.store(false, memory_order_release);
+    job.done.store(true, memory_order_release);
+}
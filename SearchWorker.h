@@ -0,0 +1,62 @@
+#pragma once
+// Busca do motor em segundo plano, para a interface não travar enquanto a AG pensa.
+#include "Agent.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Um pedido de busca. Funciona como um "future": a interface consulta ready() a cada frame
+// e lê o resultado quando a busca acaba; cancel() interrompe a busca o quanto antes.
+struct SearchJob {
+    // Entrada
+    Agent agent;
+    Board board;
+    int piece = 2;
+    int timeMs = 0;   // > 0: Aprofundamento Iterativo com orçamento de tempo (Agent::think)
+    int depth = 0;    // Profundidade fixa (timeMs == 0) ou máxima (timeMs > 0)
+    TranspositionTable* table = nullptr; // Só é tocada pela thread de busca
+
+    // Saída
+    Agent::SearchResult result = { -1, 0, 0, 0, 0 };
+    std::atomic<bool> done{ false };
+    std::atomic<bool> canceled{ false };
+    std::atomic<long long> liveNodes{ 0 };
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> running{ false };
+
+    bool ready() const { return done.load(std::memory_order_acquire); }
+    void cancel() { canceled.store(true, std::memory_order_relaxed); }
+    double nodesPerSecond() const;
+};
+
+// Thread de fundo que executa os pedidos em ordem de chegada.
+// Buscas com tempo usam `threads` threads (Lazy SMP, ver ParallelSearch.h; <= 0 = uma por núcleo).
+class SearchWorker {
+public:
+    explicit SearchWorker(int threads = 1);
+    ~SearchWorker();
+
+    // Busca com tempo (timeMs > 0, até maxDepth) ou com profundidade fixa (timeMs == 0)
+    std::shared_ptr<SearchJob> submit(const Agent& agent, const Board& board, int piece,
+                                      int timeMs, int depth, TranspositionTable* table = nullptr);
+
+    // Cancela todos os pedidos pendentes e o que estiver rodando
+    void cancelAll();
+
+private:
+    void loop();
+    void execute(SearchJob& job);
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<SearchJob>> queue;
+    std::shared_ptr<SearchJob> current;
+    bool quit = false;
+    ThreadPool pool;    // Threads auxiliares da busca paralela (a thread de fundo é o worker 0)
+    std::thread thread; // Declarada por último: só começa depois dos outros membros existirem
+};
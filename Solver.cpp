@@ -0,0 +1,152 @@
+#include "Solver.h"
+#include <algorithm>
+
+using namespace std;
+
+// Todas as casas do tabuleiro (sem os bits sentinela)
+static const uint64_t BOARD_MASK = BOTTOM_MASK * ((1ULL << ROWS) - 1);
+
+// Casas vazias que completariam um 4 em linha para as pedras em `position`
+static uint64_t WinningSpots(uint64_t position, uint64_t mask) {
+    // Vertical
+    uint64_t r = (position << 1) & (position << 2) & (position << 3);
+    // Horizontal e diagonais: a casa pode estar em qualquer uma das 4 posições da linha
+    const int shifts[3] = { BB_HEIGHT, BB_HEIGHT - 1, BB_HEIGHT + 1 };
+    for (int d : shifts) {
+        uint64_t p = (position << d) & (position << (2 * d));
+        r |= p & (position << (3 * d));
+        r |= p & (position >> d);
+        p = (position >> d) & (position >> (2 * d));
+        r |= p & (position << d);
+        r |= p & (position >> (3 * d));
+    }
+    return r & (BOARD_MASK ^ mask);
+}
+
+// Casas jogáveis agora (a primeira vazia de cada coluna)
+static uint64_t Playable(uint64_t mask) { return (mask + BOTTOM_MASK) & BOARD_MASK; }
+
+// Jogadas que não entregam a vitória ao oponente na jogada seguinte:
+// se ele ameaça ganhar, só bloquear serve (duas ameaças = derrota); e nunca jogar
+// logo abaixo de uma casa vencedora dele
+static uint64_t NonLosingMoves(uint64_t current, uint64_t mask) {
+    uint64_t possible = Playable(mask);
+    uint64_t oppWins = WinningSpots(current ^ mask, mask);
+    uint64_t forced = possible & oppWins;
+    if (forced) {
+        if (forced & (forced - 1)) return 0;
+        possible = forced;
+    }
+    return possible & ~(oppWins >> 1);
+}
+
+Solver::Solver(int cacheBits) : cache((size_t)1 << cacheBits, 0), cacheShift(64 - cacheBits) {}
+
+void Solver::clearCache() { for (uint64_t& e : cache) e = 0; }
+
+bool Solver::pollAbort() {
+    if (cancelFlag && cancelFlag->load(memory_order_relaxed)) aborted = true;
+    if (useDeadline && chrono::steady_clock::now() >= deadline) aborted = true;
+    return aborted;
+}
+
+int Solver::negamax(uint64_t current, uint64_t mask, int moves, int alpha, int beta) {
+    nodes++;
+    if ((nodes & 4095) == 0 && pollAbort()) return 0;
+    if (aborted) return 0;
+
+    // Pré-condição: quem joga não vence na hora (tratado por quem chama)
+    uint64_t next = NonLosingMoves(current, mask);
+    if (next == 0) return -(ROWS * COLS - moves) / 2; // Toda jogada perde
+    if (moves >= ROWS * COLS - 2) return 0;            // Empate (as últimas casas não dão vitória)
+
+    // Limites: o oponente não vence na próxima jogada, e nós não vencemos nesta
+    int lo = -(ROWS * COLS - 2 - moves) / 2;
+    if (alpha < lo) { alpha = lo; if (alpha >= beta) return alpha; }
+    int hi = (ROWS * COLS - 1 - moves) / 2;
+
+    // Cache: limite superior (valor <= MAX_SCORE - MIN_SCORE + 1) ou inferior (acima disso).
+    // A chave espelhada é o espelho da chave (cada coluna fica no seu trecho), e a posição
+    // espelhada tem o mesmo valor: as duas usam a menor.
+    uint64_t key = current + mask;
+    key = min(key, MirrorBits(key));
+    uint64_t& slot = cache[(key * 0x9E3779B97F4A7C15ULL) >> cacheShift];
+    if ((slot >> 8) == key && (slot & 0xFF)) {
+        int v = (int)(slot & 0xFF);
+        if (v > MAX_SCORE - MIN_SCORE + 1) {
+            lo = v + 2 * MIN_SCORE - MAX_SCORE - 2;
+            if (alpha < lo) { alpha = lo; if (alpha >= beta) return alpha; }
+        }
+        else {
+            hi = v + MIN_SCORE - 1;
+            if (beta > hi) { beta = hi; if (alpha >= beta) return beta; }
+        }
+    }
+    if (beta > hi) { beta = hi; if (alpha >= beta) return beta; }
+
+    // Ordena pelas ameaças criadas (mais casas vencedoras primeiro), centro desempata
+    static const int order[] = { 3, 2, 4, 1, 5, 0, 6 };
+    uint64_t moveBits[COLS]; int moveScore[COLS]; int n = 0;
+    for (int c : order) {
+        uint64_t m = next & ColumnMask(c);
+        if (!m) continue;
+        int s = PopCount(WinningSpots(current | m, mask));
+        int i = n++;
+        for (; i > 0 && moveScore[i - 1] < s; i--) { moveBits[i] = moveBits[i - 1]; moveScore[i] = moveScore[i - 1]; }
+        moveBits[i] = m; moveScore[i] = s;
+    }
+
+    for (int i = 0; i < n; i++) {
+        // Jogar: a vez passa ao oponente (current vira as pedras dele)
+        int score = -negamax(current ^ mask, mask | moveBits[i], moves + 1, -beta, -alpha);
+        if (aborted) return 0;
+        if (score >= beta) {
+            slot = (key << 8) | (uint64_t)(score + MAX_SCORE - 2 * MIN_SCORE + 2);
+            return score;
+        }
+        if (score > alpha) alpha = score;
+    }
+    slot = (key << 8) | (uint64_t)(alpha - MIN_SCORE + 1);
+    return alpha;
+}
+
+int Solver::solve(uint64_t current, uint64_t mask, int moves) {
+    if (WinningSpots(current, mask) & Playable(mask)) return (ROWS * COLS + 1 - moves) / 2;
+    // Busca com janela nula: cada chamada só responde "valor > med?", estreitando [lo, hi]
+    int lo = -(ROWS * COLS - moves) / 2, hi = (ROWS * COLS + 1 - moves) / 2;
+    while (lo < hi && !aborted) {
+        int med = lo + (hi - lo) / 2;
+        // Testa primeiro perto de 0 (empate), onde a maioria das posições está
+        if (med <= 0 && lo / 2 < med) med = lo / 2;
+        else if (med >= 0 && hi / 2 > med) med = hi / 2;
+        int r = negamax(current, mask, moves, med, med + 1);
+        if (r <= med) hi = r; else lo = r;
+    }
+    return lo;
+}
+
+int Solver::solve(const Board& b) {
+    aborted = false;
+    int moves = b.moveCount();
+    return solve(b.pieces[moves % 2], b.pieces[0] | b.pieces[1], moves);
+}
+
+int Solver::bestMove(const Board& b, int& score) {
+    aborted = false;
+    int moves = b.moveCount();
+    uint64_t current = b.pieces[moves % 2], mask = b.pieces[0] | b.pieces[1];
+    static const int order[] = { 3, 2, 4, 1, 5, 0, 6 };
+    int best = -1;
+    bool symmetric = b.isSymmetric(); // Colunas espelhadas valem o mesmo: a da esquerda vem antes
+    for (int c : order) {
+        if (!b.isValid(c) || (symmetric && c > COLS / 2)) continue;
+        uint64_t m = Playable(mask) & ColumnMask(c);
+        int s;
+        if (WinningSpots(current, mask) & m) s = (ROWS * COLS + 1 - moves) / 2; // Vitória imediata
+        else if (moves + 1 == ROWS * COLS) s = 0;                                // Última casa: empate
+        else s = -solve(current ^ mask, mask | m, moves + 1);
+        if (aborted) return -1;
+        if (best < 0 || s > score) { best = c; score = s; }
+    }
+    return best;
+}
@@ -0,0 +1,42 @@
+#pragma once
+// Solver exato de finais: negamax com janela nula, detecção de ameaças por bitboard e
+// cache próprio das soluções. Diferente do Minimax, não usa heurística: o valor é o
+// resultado real do jogo com jogo perfeito dos dois lados.
+#include "Board.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+class Solver {
+public:
+    // Valor de uma posição para quem joga: > 0 vence, 0 empata, < 0 perde.
+    // |valor| = casas que sobram para o vencedor depois da vitória, dividido por 2, mais 1
+    // (vitórias mais rápidas valem mais).
+    static const int MIN_SCORE = -(ROWS * COLS) / 2 + 3;
+    static const int MAX_SCORE = (ROWS * COLS + 1) / 2 - 3;
+
+    long long nodes = 0;
+    // Interrupção (mesmo esquema do Agent): prazo e pedido de cancelamento opcionais
+    bool useDeadline = false;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancelFlag = nullptr;
+    bool aborted = false; // A última chamada foi interrompida: o resultado não vale
+
+    explicit Solver(int cacheBits = 21); // 2^cacheBits entradas de 8 bytes
+    void clearCache();
+
+    // Valor exato da posição para o lado que joga (pela quantidade de pedras)
+    int solve(const Board& b);
+
+    // Melhor coluna para o lado que joga (centro primeiro em caso de empate) e o seu valor;
+    // -1 se a busca foi interrompida
+    int bestMove(const Board& b, int& score);
+
+private:
+    std::vector<uint64_t> cache; // (chave << 8) | valor, endereçada pelo hash da chave
+    int cacheShift;
+
+    int solve(uint64_t current, uint64_t mask, int moves);
+    int negamax(uint64_t current, uint64_t mask, int moves, int alpha, int beta);
+    bool pollAbort();
+};
@@ -0,0 +1,139 @@
+#include "Stats.h"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+static const char* COUNTER_NAMES[STAT_COUNTERS] = {
+    "nodes", "cutoffs", "immediate_wins", "leaf_evals", "tt_hits", "tt_cutoffs", "symmetric_nodes",
+    "games", "cached_games", "opening_hits", "generations", "frames"
+};
+static const char* TIMER_NAMES[STAT_TIMERS] = { "generation", "matches", "selection", "reproduction", "frame" };
+
+const char* StatCounterName(int c) { return COUNTER_NAMES[c]; }
+const char* StatTimerName(int t) { return TIMER_NAMES[t]; }
+
+// Blocos fixos (registrar uma thread não aloca memória). Se todos estiverem em uso, as threads
+// a mais dividem o último bloco e as contagens delas ficam aproximadas.
+const int MAX_STAT_THREADS = 256;
+static StatBlock blocks[MAX_STAT_THREADS + 1];
+static int freeSlots[MAX_STAT_THREADS], freeCount = -1;
+static mutex registryMutex;
+static StatSnapshot retired, baseline; // Somas das threads que terminaram; ponto zero do ResetStats
+static chrono::steady_clock::time_point resetTime = chrono::steady_clock::now();
+
+thread_local StatBlock* statBlock = nullptr;
+
+// Quando a thread termina, soma o bloco em retired e o devolve
+struct StatRelease {
+    int slot = -1;
+    ~StatRelease() {
+        if (slot < 0) return;
+        lock_guard<mutex> lock(registryMutex);
+        StatBlock& b = blocks[slot];
+        for (int c = 0; c < STAT_COUNTERS; c++) retired.count[c] += b.count[c].exchange(0, memory_order_relaxed);
+        for (int t = 0; t < STAT_TIMERS; t++) {
+            retired.ns[t] += b.ns[t].exchange(0, memory_order_relaxed);
+            retired.calls[t] += b.calls[t].exchange(0, memory_order_relaxed);
+        }
+        freeSlots[freeCount++] = slot;
+        statBlock = nullptr;
+    }
+};
+static thread_local StatRelease statRelease;
+
+StatBlock* RegisterStatThread() {
+    lock_guard<mutex> lock(registryMutex);
+    if (freeCount < 0) {
+        // Primeiro uso: todos os blocos livres, em ordem (o 0 sai primeiro)
+        for (int i = 0; i < MAX_STAT_THREADS; i++) freeSlots[i] = MAX_STAT_THREADS - 1 - i;
+        freeCount = MAX_STAT_THREADS;
+    }
+    if (freeCount == 0) return statBlock = &blocks[MAX_STAT_THREADS];
+    statRelease.slot = freeSlots[--freeCount];
+    return statBlock = &blocks[statRelease.slot];
+}
+
+StatSnapshot StatSnapshot::operator-(const StatSnapshot& o) const {
+    StatSnapshot d;
+    for (int c = 0; c < STAT_COUNTERS; c++) d.count[c] = count[c] - o.count[c];
+    for (int t = 0; t < STAT_TIMERS; t++) { d.ns[t] = ns[t] - o.ns[t]; d.calls[t] = calls[t] - o.calls[t]; }
+    d.seconds = seconds - o.seconds;
+    return d;
+}
+
+// Soma bruta (sem descontar o baseline); chamada com registryMutex travado
+static void SumBlocks(StatSnapshot& out) {
+    out = retired;
+    for (const StatBlock& b : blocks) {
+        for (int c = 0; c < STAT_COUNTERS; c++) out.count[c] += b.count[c].load(memory_order_relaxed);
+        for (int t = 0; t < STAT_TIMERS; t++) {
+            out.ns[t] += b.ns[t].load(memory_order_relaxed);
+            out.calls[t] += b.calls[t].load(memory_order_relaxed);
+        }
+    }
+}
+
+void CollectStats(StatSnapshot& out) {
+    lock_guard<mutex> lock(registryMutex);
+    SumBlocks(out);
+    out = out - baseline;
+    out.seconds = chrono::duration<double>(chrono::steady_clock::now() - resetTime).count();
+}
+
+void ResetStats() {
+    lock_guard<mutex> lock(registryMutex);
+    SumBlocks(baseline);
+    resetTime = chrono::steady_clock::now();
+}
+
+// ---------------------------------------------------------------------------------------------
+// Série de amostras
+
+void StatTrace::start() {
+    rows.clear();
+    CollectStats(last);
+}
+
+const StatSnapshot& StatTrace::sample(const char* label, int index) {
+    StatSnapshot now;
+    CollectStats(now);
+    rows.push_back({ label, index, now - last });
+    last = now;
+    return rows.back().delta;
+}
+
+bool StatTrace::write(const string& path) const {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    bool csv = path.size() >= 4 && !strcmp(path.c_str() + path.size() - 4, ".csv");
+    if (csv) {
+        // Uma linha por amostra: contadores, depois ms e chamadas de cada cronômetro
+        fprintf(f, "label,index,seconds");
+        for (int c = 0; c < STAT_COUNTERS; c++) fprintf(f, ",%s", COUNTER_NAMES[c]);
+        for (int t = 0; t < STAT_TIMERS; t++) fprintf(f, ",%s_ms,%s_calls", TIMER_NAMES[t], TIMER_NAMES[t]);
+        fprintf(f, "\n");
+        for (const Row& r : rows) {
+            fprintf(f, "%s,%d,%.6f", r.label, r.index, r.delta.seconds);
+            for (int c = 0; c < STAT_COUNTERS; c++) fprintf(f, ",%llu", (unsigned long long)r.delta.count[c]);
+            for (int t = 0; t < STAT_TIMERS; t++)
+                fprintf(f, ",%.3f,%llu", r.delta.ms(t), (unsigned long long)r.delta.calls[t]);
+            fprintf(f, "\n");
+        }
+    }
+    else {
+        fprintf(f, "{\n  \"stats_enabled\": %s,\n  \"samples\": [\n", C4_STATS ? "true" : "false");
+        for (size_t i = 0; i < rows.size(); i++) {
+            const Row& r = rows[i];
+            fprintf(f, "    {\"label\": \"%s\", \"index\": %d, \"seconds\": %.6f", r.label, r.index, r.delta.seconds);
+            for (int c = 0; c < STAT_COUNTERS; c++) fprintf(f, ", \"%s\": %llu", COUNTER_NAMES[c], (unsigned long long)r.delta.count[c]);
+            for (int t = 0; t < STAT_TIMERS; t++)
+                fprintf(f, ", \"%s_ms\": %.3f, \"%s_calls\": %llu", TIMER_NAMES[t], r.delta.ms(t), TIMER_NAMES[t],
+                        (unsigned long long)r.delta.calls[t]);
+            fprintf(f, "}%s\n", i + 1 < rows.size() ? "," : "");
+        }
+        fprintf(f, "  ]\n}\n");
+    }
+    return fclose(f) == 0;
+}
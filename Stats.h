@@ -0,0 +1,115 @@
+#pragma once
+// Instrumentação: contadores e cronômetros por thread (busca, evolução e interface), somados
+// só quando alguém pede um retrato (CollectStats). Cada thread escreve no seu próprio bloco,
+// sem locks e sem instruções atômicas de leitura-modificação-escrita, então o custo num nó do
+// Minimax é uma soma na memória da própria thread.
+// Compile com -DC4_STATS=0 para remover tudo: as macros STAT_* viram nada.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef C4_STATS
+#define C4_STATS 1
+#endif
+
+enum StatCounter {
+    STAT_NODES,          // Nós visitados pelo Minimax
+    STAT_CUTOFFS,        // Podas alpha-beta
+    STAT_IMMEDIATE_WINS, // Atalhos de vitória (ou bloqueio) imediata antes da recursão
+    STAT_LEAF_EVALS,     // Folhas avaliadas pela heurística (scoreBoard)
+    STAT_TT_HITS,        // Posições encontradas na Tabela de Transposição
+    STAT_TT_CUTOFFS,     // ... cujo score foi reaproveitado sem buscar
+    STAT_SYMMETRIC_NODES, // Nós em posição simétrica (só metade das colunas é buscada)
+    STAT_GAMES,          // Partidas de treino jogadas
+    STAT_CACHED_GAMES,   // Partidas de treino vindas do cache de resultados
+    STAT_OPENING_HITS,   // Jogadas de abertura do treino vindas do cache de aberturas
+    STAT_GENERATIONS,
+    STAT_FRAMES,         // Frames da interface
+    STAT_COUNTERS
+};
+
+enum StatTimer {
+    TIMER_GENERATION,    // EvolveOneGeneration inteiro
+    TIMER_MATCHES,       // ... torneio (partidas)
+    TIMER_SELECTION,     // ... ordenação por fitness
+    TIMER_REPRODUCTION,  // ... crossover e mutação
+    TIMER_FRAME,         // Um frame da interface (inclui a espera do vsync)
+    STAT_TIMERS
+};
+
+const char* StatCounterName(int c);
+const char* StatTimerName(int t);
+
+// Bloco de uma thread. Só a dona escreve (load + store relaxados); as outras só leem ao somar.
+struct alignas(64) StatBlock {
+    std::atomic<uint64_t> count[STAT_COUNTERS];
+    std::atomic<uint64_t> ns[STAT_TIMERS];
+    std::atomic<uint64_t> calls[STAT_TIMERS];
+
+    void add(int c, uint64_t n) { count[c].store(count[c].load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    void time(int t, uint64_t elapsed) {
+        ns[t].store(ns[t].load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+        calls[t].store(calls[t].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
+
+// Bloco da thread atual (registrado no primeiro uso; devolvido quando a thread termina)
+extern thread_local StatBlock* statBlock;
+StatBlock* RegisterStatThread();
+inline StatBlock& ThreadStats() { StatBlock* b = statBlock; return b ? *b : *RegisterStatThread(); }
+
+// Cronômetro de escopo: soma o tempo até o fim do bloco no cronômetro t
+class StatScope {
+public:
+    explicit StatScope(int timer) : t(timer), start(std::chrono::steady_clock::now()) {}
+    ~StatScope() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        ThreadStats().time(t, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+private:
+    int t;
+    std::chrono::steady_clock::time_point start;
+};
+
+#if C4_STATS
+#define STAT_ADD(c, n) ThreadStats().add((c), (n))
+#define STAT_INC(c) ThreadStats().add((c), 1)
+#define STAT_CAT2(a, b) a##b
+#define STAT_CAT(a, b) STAT_CAT2(a, b)
+#define STAT_SCOPE(t) StatScope STAT_CAT(statScope, __LINE__)(t)
+#else
+#define STAT_ADD(c, n) ((void)0)
+#define STAT_INC(c) ((void)0)
+#define STAT_SCOPE(t) ((void)0)
+#endif
+
+// Soma de todas as threads (inclusive as que já terminaram) desde o último ResetStats
+struct StatSnapshot {
+    uint64_t count[STAT_COUNTERS] = {};
+    uint64_t ns[STAT_TIMERS] = {};
+    uint64_t calls[STAT_TIMERS] = {};
+    double seconds = 0;  // Tempo de relógio desde o último ResetStats
+
+    double ms(int t) const { return ns[t] / 1e6; }
+    double perSecond(int c) const { return seconds > 0 ? count[c] / seconds : 0; }
+    StatSnapshot operator-(const StatSnapshot& o) const;
+};
+void CollectStats(StatSnapshot& out);
+void ResetStats();
+
+// Série de amostras (por exemplo uma por geração), cada uma com a diferença desde a anterior,
+// exportada em CSV (caminho terminado em .csv) ou JSON
+class StatTrace {
+public:
+    void start();                            // Esvazia a série; a primeira amostra conta a partir daqui
+    const StatSnapshot& sample(const char* label, int index); // Devolve a diferença gravada
+    bool write(const std::string& path) const;
+    int size() const { return (int)rows.size(); }
+
+private:
+    struct Row { const char* label; int index; StatSnapshot delta; };
+    std::vector<Row> rows;
+    StatSnapshot last;
+};
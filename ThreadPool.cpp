@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int workers) {
+    if (workers <= 0) workers = max(1, (int)thread::hardware_concurrency());
+    queues.reset(new Queue[workers]);
+    numWorkers = workers;
+    for (int i = 1; i < workers; i++) threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    { lock_guard<mutex> lk(m); quit = true; }
+    wake.notify_all();
+    for (thread& t : threads) t.join();
+}
+
+// Divide as tarefas em faixas iguais, uma por worker, e trabalha junto até todas acabarem
+void ThreadPool::run(int count) {
+    for (int w = 0; w < numWorkers; w++) {
+        lock_guard<mutex> lk(queues[w].m);
+        queues[w].lo = (int)((long long)count * w / numWorkers);
+        queues[w].hi = (int)((long long)count * (w + 1) / numWorkers);
+    }
+    {
+        lock_guard<mutex> lk(m);
+        remaining = count;
+        busy = numWorkers - 1;
+        round++;
+    }
+    wake.notify_all();
+    work(0);
+    unique_lock<mutex> lk(m);
+    done.wait(lk, [&] { return remaining == 0 && busy == 0; });
+}
+
+void ThreadPool::workerLoop(int id) {
+    int seen = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lk(m);
+            wake.wait(lk, [&] { return quit || round != seen; });
+            if (quit) return;
+            seen = round;
+        }
+        work(id);
+        lock_guard<mutex> lk(m);
+        busy--;
+        if (busy == 0 && remaining == 0) done.notify_all();
+    }
+}
+
+void ThreadPool::work(int id) {
+    int task;
+    while (nextTask(id, task)) {
+        jobFn(job, task, id);
+        lock_guard<mutex> lk(m);
+        remaining--;
+        if (remaining == 0 && busy == 0) done.notify_all();
+    }
+}
+
+// Pega a próxima tarefa da própria faixa; se estiver vazia, rouba metade da faixa de outro
+bool ThreadPool::nextTask(int id, int& task) {
+    {
+        lock_guard<mutex> lk(queues[id].m);
+        if (queues[id].lo < queues[id].hi) { task = queues[id].lo++; return true; }
+    }
+    for (int k = 1; k < numWorkers; k++) {
+        Queue& victim = queues[(id + k) % numWorkers];
+        int lo, hi;
+        {
+            lock_guard<mutex> lk(victim.m);
+            int n = victim.hi - victim.lo;
+            if (n <= 0) continue;
+            hi = victim.hi;
+            lo = victim.hi - (n + 1) / 2;
+            victim.hi = lo;
+        }
+        task = lo;
+        lock_guard<mutex> lk(queues[id].m);
+        queues[id].lo = lo + 1; queues[id].hi = hi;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+// Pool de Threads com Roubo de Tarefas (Work Stealing)
+// parallelFor(n, f) executa f(tarefa, worker) para tarefa = 0..n-1. Cada worker começa com
+// uma faixa contígua de tarefas; quem termina a sua rouba metade da faixa de outro worker.
+// A thread que chama também trabalha (como worker 0) e só retorna quando tudo acabou.
+class ThreadPool {
+public:
+    explicit ThreadPool(int workers); // workers <= 0: uma thread por núcleo
+    ~ThreadPool();
+    int size() const { return numWorkers; }
+
+    template<class F> void parallelFor(int count, F&& body) {
+        job = (void*)&body;
+        jobFn = [](void* f, int task, int worker) { (*(typename std::remove_reference<F>::type*)f)(task, worker); };
+        run(count);
+    }
+
+private:
+    struct alignas(64) Queue { std::mutex m; int lo = 0, hi = 0; };
+
+    void run(int count);
+    void workerLoop(int id);
+    void work(int id);
+    bool nextTask(int id, int& task);
+
+    int numWorkers = 1;
+    std::unique_ptr<Queue[]> queues;
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable wake, done;
+    int round = 0, remaining = 0, busy = 0;
+    bool quit = false;
+    void* job = nullptr;
+    void (*jobFn)(void*, int, int) = nullptr;
+};
@@ -0,0 +1,193 @@
+#include "Tournament.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+const char* ScheduleName(TournamentSchedule s) {
+    switch (s) {
+    case SCHEDULE_ROUND_ROBIN: return "round-robin";
+    case SCHEDULE_SWISS: return "swiss";
+    case SCHEDULE_RACING: return "racing";
+    default: return "random";
+    }
+}
+
+bool ParseSchedule(const char* name, TournamentSchedule& out) {
+    for (int s = SCHEDULE_RANDOM; s <= SCHEDULE_RACING; s++)
+        if (!strcmp(name, ScheduleName((TournamentSchedule)s))) { out = (TournamentSchedule)s; return true; }
+    return false;
+}
+
+void RoundRobinPairings(int n, const uint64_t* ids, vector<Pairing>& out) {
+    out.clear();
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++) {
+            // Um bit do par decide se o id menor ou o maior começa
+            bool lowFirst = ((ids[i] ^ ids[j]) >> 17) & 1;
+            out.push_back((ids[i] < ids[j]) == lowFirst ? Pairing{ i, j } : Pairing{ j, i });
+        }
+}
+
+int RacingStages(int popSize, int depth, int elite, int parents, RacingStage* out) {
+    RacingStage wanted[3] = { { max(1, depth - 2), popSize },
+                              { max(1, depth - 1), min(popSize, 2 * parents) },
+                              { depth, min(popSize, max(2, 2 * elite)) } };
+    int n = 0;
+    for (const RacingStage& s : wanted) {
+        // Mesmo grupo da etapa anterior: fica só a mais funda
+        if (n > 0 && s.agents >= out[n - 1].agents) out[n - 1].depth = s.depth;
+        else out[n++] = s;
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Sistema suíço
+
+void SwissSystem::reset(int count) {
+    n = count;
+    points.assign(n, 0);
+    firstCount.assign(n, 0);
+    order.resize(n);
+    met.assign((size_t)n * n, 0);
+    hadBye.assign(n, 0);
+    paired.assign(n, 0);
+}
+
+void SwissSystem::pair(int round, vector<Pairing>& out) {
+    out.clear();
+    // Classificação: mais pontos primeiro; empate pelo índice (elite primeiro), sempre a mesma ordem
+    for (int i = 0; i < n; i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return points[a] > points[b]; });
+    fill(paired.begin(), paired.end(), 0);
+
+    // n ímpar: o pior colocado que ainda não folgou fica de fora e ganha o ponto da rodada
+    if (n % 2) {
+        int bye = order[n - 1];
+        for (int k = n - 1; k >= 0; k--) if (!hadBye[order[k]]) { bye = order[k]; break; }
+        hadBye[bye] = 1; paired[bye] = 1; points[bye] += 1;
+    }
+    // Quem começou menos vezes é P1 (empate: o melhor colocado)
+    auto add = [&](int a, int b) {
+        if (firstCount[b] < firstCount[a]) swap(a, b);
+        out.push_back({ a, b });
+        firstCount[a]++;
+        paired[a] = paired[b] = 1;
+        met[(size_t)a * n + b] = met[(size_t)b * n + a] = 1;
+    };
+    if (round == 0) {
+        // Primeira rodada: i-ésimo da metade de cima contra o i-ésimo da metade de baixo
+        int m = 0;
+        for (int k = 0; k < n; k++) if (!paired[order[k]]) order[m++] = order[k];
+        for (int k = 0; k < m / 2; k++) add(order[k], order[m / 2 + k]);
+        return;
+    }
+    for (int k = 0; k < n; k++) {
+        int a = order[k];
+        if (paired[a]) continue;
+        int rematch = -1, b = -1;
+        for (int j = k + 1; j < n && b < 0; j++) {
+            int c = order[j];
+            if (paired[c]) continue;
+            if (!met[(size_t)a * n + c]) b = c;
+            else if (rematch < 0) rematch = c;
+        }
+        if (b < 0) b = rematch;
+        if (b >= 0) add(a, b);
+    }
+}
+
+void SwissSystem::record(const GameResult& r) {
+    points[r.p1] += r.score;
+    points[r.p2] += 1 - r.score;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Cache de resultados
+
+void MatchCache::clear() {
+    fill(entries.begin(), entries.end(), Entry{ 0, 0 });
+    hits = misses = 0;
+}
+
+bool MatchCache::probe(uint64_t key, int& winner) {
+    const Entry& e = entries[key & (entries.size() - 1)];
+    if (e.key == key) { winner = e.winner; hits++; return true; }
+    misses++;
+    return false;
+}
+
+void MatchCache::store(uint64_t key, int winner) {
+    entries[key & (entries.size() - 1)] = { key, winner };
+}
+
+void OpeningCache::clear() {
+    for (size_t i = 0, n = size_t(1) << (64 - shift); i < n; i++) entries[i].store(0, memory_order_relaxed);
+}
+
+// O índice sai dos bits altos da chave e a entrada guarda os bits acima da coluna (4 bits)
+bool OpeningCache::probe(uint64_t key, int& col) const {
+    uint64_t e = entries[key >> shift].load(memory_order_relaxed);
+    if ((e & 15) == 0 || ((e ^ key) >> 4) != 0) return false;
+    col = (int)(e & 15) - 1;
+    return true;
+}
+
+void OpeningCache::store(uint64_t key, int col) {
+    entries[key >> shift].store((key & ~15ULL) | (uint64_t)(col + 1), memory_order_relaxed);
+}
+
+uint64_t OpeningKey(uint64_t genome, uint64_t position, int depth, int board) {
+    uint64_t s = genome * 0x9E3779B97F4A7C15ULL ^ position;
+    s = SplitMix64(s) ^ (uint64_t)board << 40 ^ (uint64_t)depth << 48;
+    return SplitMix64(s);
+}
+
+uint64_t MatchKey(const Genome& a, const Genome& b, int depth, int adjudicateEmpty, int board, int openingPlies) {
+    uint64_t s = GenomeHash(a.data(), GENOME_SIZE) * 0x9E3779B97F4A7C15ULL ^ GenomeHash(b.data(), GENOME_SIZE);
+    s ^= (uint64_t)openingPlies << 32 ^ (uint64_t)board << 40 ^ (uint64_t)depth << 48 ^ (uint64_t)adjudicateEmpty << 56;
+    uint64_t key = SplitMix64(s);
+    return key ? key : 1;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Elo
+
+void EloRatings(int n, const vector<GameResult>& games, double* ratings) {
+    // Buffers reaproveitados entre gerações (o treino não aloca depois da primeira)
+    static vector<double> grad, curv;
+    grad.resize(n);
+    curv.resize(n);
+    for (int i = 0; i < n; i++) ratings[i] = 1500;
+
+    auto expected = [](double ra, double rb) { return 1 / (1 + pow(10.0, (rb - ra) / 400)); };
+    // Passo de Newton por agente: (score - esperado) / (derivada do esperado), limitado a 200 pontos
+    const double slope = log(10.0) / 400;
+    for (int it = 0; it < 200; it++) {
+        for (int i = 0; i < n; i++) {
+            double e = expected(ratings[i], 1500); // Empate virtual contra 1500
+            grad[i] = 0.5 - e;
+            curv[i] = e * (1 - e);
+        }
+        for (const GameResult& g : games) {
+            double e = expected(ratings[g.p1], ratings[g.p2]);
+            grad[g.p1] += g.score - e; grad[g.p2] -= g.score - e;
+            curv[g.p1] += e * (1 - e); curv[g.p2] += e * (1 - e);
+        }
+        double mean = 0;
+        for (int i = 0; i < n; i++) {
+            grad[i] = max(-200.0, min(200.0, grad[i] / (slope * curv[i]))); // Passo
+            mean += ratings[i] + grad[i];
+        }
+        // Só as diferenças de rating importam: a média fica fixa em 1500 (sem isso, o
+        // deslocamento de todos juntos, que só o empate virtual define, converge devagar)
+        double shift = 1500 - mean / n, maxStep = 0;
+        for (int i = 0; i < n; i++) {
+            ratings[i] += grad[i] + shift;
+            maxStep = max(maxStep, fabs(grad[i] + shift));
+        }
+        if (maxStep < 1e-3) break;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+// Torneio da evolução: quem joga contra quem (round-robin, suíço, corrida ou k oponentes
+// aleatórios), cache de resultados por par de genomas e ratings Elo.
+#include "Agent.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+enum TournamentSchedule {
+    SCHEDULE_RANDOM = 0,   // Cada agente joga matchesPerAgent partidas como P1 contra oponentes aleatórios
+    SCHEDULE_ROUND_ROBIN,  // Todos contra todos, uma partida por par
+    SCHEDULE_SWISS,        // matchesPerAgent rodadas; cada rodada junta agentes com pontuação parecida
+    SCHEDULE_RACING        // Corrida: todos jogam partidas rasas; só os candidatos aos cortes da seleção
+                           // (terço superior e elite) jogam mais, cada vez mais fundo (ver RacingStages)
+};
+const char* ScheduleName(TournamentSchedule s);
+bool ParseSchedule(const char* name, TournamentSchedule& out);
+
+// Uma partida: índices de quem começa (p1) e de quem responde (p2)
+struct Pairing { int p1, p2; };
+
+// Etapas da corrida (successive halving). Cada etapa joga com os `agents` melhores da etapa
+// anterior, na profundidade `depth`: todos na profundidade depth - 2; os 2 * parents melhores
+// em depth - 1; os 2 * elite melhores na profundidade do treino. Etapas que não reduziriam o
+// grupo são juntadas à seguinte. Devolve o número de etapas (no máximo 3).
+struct RacingStage { int depth, agents; };
+int RacingStages(int popSize, int depth, int elite, int parents, RacingStage* out);
+
+// Resultado de uma partida: score de p1 (1 = vitória, 0.5 = empate, 0 = derrota)
+struct GameResult { int p1, p2; double score; };
+
+// Todos contra todos. Quem começa depende só do par de ids (GenomeHash de cada agente) e
+// fica equilibrado em média; assim o mesmo par repete a mesma partida (e acerta o cache) nas
+// gerações seguintes, mesmo que os agentes mudem de posição na população.
+void RoundRobinPairings(int n, const uint64_t* ids, std::vector<Pairing>& out);
+
+// Rodadas do sistema suíço. Guarda quem já enfrentou quem, os pontos, quantas vezes cada
+// agente começou e quem já folgou (com n ímpar, um agente fica de fora em cada rodada).
+class SwissSystem {
+public:
+    void reset(int n);
+    // Rodada 1: metade de cima contra metade de baixo. Depois: ordena por pontos e junta
+    // vizinhos que ainda não se enfrentaram (se não houver, aceita a revanche).
+    void pair(int round, std::vector<Pairing>& out);
+    void record(const GameResult& r);
+
+private:
+    int n = 0;
+    std::vector<double> points;
+    std::vector<int> firstCount, order;
+    std::vector<uint8_t> met, hadBye, paired;
+};
+
+// Cache de resultados: o treino é determinístico (mesmos genomas, profundidade e adjudicação
+// = mesma partida), então o resultado de um par já jogado é reaproveitado, por exemplo entre
+// os agentes da elite que passam inalterados para a próxima geração.
+// Tabela de endereçamento direto: uma colisão só sobrescreve a entrada antiga.
+class MatchCache {
+public:
+    long long hits = 0, misses = 0;
+
+    explicit MatchCache(int bits = 16) : entries(size_t(1) << bits) {}
+    void clear();
+    bool probe(uint64_t key, int& winner);
+    void store(uint64_t key, int winner);
+
+private:
+    struct Entry { uint64_t key; int winner; };
+    std::vector<Entry> entries;
+};
+
+// Chave de uma partida (a ordem importa: a é P1). Nunca é zero. board é o BoardVariant e
+// openingPlies as jogadas que saem do cache de aberturas: tudo o que muda o resultado entra na chave.
+uint64_t MatchKey(const Genome& a, const Genome& b, int depth, int adjudicateEmpty, int board, int openingPlies);
+
+// Cache de aberturas: a coluna que um genoma escolhe numa posição do começo da partida, com a
+// posição na orientação canônica (a menor chave entre ela e o espelho). A busca do treino é
+// determinística, então cada chave tem uma única coluna possível: as threads do torneio gravam
+// e leem sem locks (uma palavra atômica por entrada) e uma corrida só custa uma busca a mais.
+class OpeningCache {
+public:
+    explicit OpeningCache(int bits = 16) : entries(new std::atomic<uint64_t>[size_t(1) << bits]), shift(64 - bits) { clear(); }
+    void clear();
+    bool probe(uint64_t key, int& col) const;
+    void store(uint64_t key, int col);
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> entries; // Bits altos da chave | coluna + 1
+    int shift;
+};
+
+// Chave de uma posição canônica (BoardT::key) para um genoma (GenomeHash) e uma profundidade
+uint64_t OpeningKey(uint64_t genome, uint64_t position, int depth, int board);
+
+// Ratings Elo de n agentes a partir dos resultados. A atualização de Elo de todas as partidas
+// é aplicada ao mesmo tempo, repetidamente, até estabilizar: o resultado não depende da ordem
+// das partidas. Um empate virtual contra um rating de 1500 mantém finito o rating de quem
+// venceu (ou perdeu) todas; a média dos ratings fica em 1500.
+void EloRatings(int n, const std::vector<GameResult>& games, double* ratings);
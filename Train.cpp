@@ -0,0 +1,210 @@
+// connect4-train: treino headless (sem janela e sem raylib), na velocidade máxima da CPU.
+// Uso: connect4-train [--population N] [--generations N] [--depth N] [--mutation R]
+//                     [--seed S] [--threads N] [--out arquivo]
+//                     [--schedule random|round-robin|swiss|racing] [--matches N]
+//                     [--checkpoint arquivo] [--checkpoint-every N] [--resume arquivo]
+//                     [--islands N] [--migrate-every K] [--migrants M] [--stats arquivo]
+//                     [--board 6x7|5x6|7x8] [--games arquivo]
+#include "Checkpoint.h"
+#include "Island.h"
+#include "Stats.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+static void PrintUsage() {
+    printf("Uso: connect4-train [opcoes]\n"
+           "  --population N   Tamanho da populacao (padrao %d)\n"
+           "  --generations N  Geracoes a evoluir (padrao 50)\n"
+           "  --depth N        Profundidade do Minimax no treino (padrao 4)\n"
+           "  --mutation R     Taxa de mutacao entre 0 e 1 (padrao %.2f)\n"
+           "  --seed S         Semente (padrao: aleatoria)\n"
+           "  --threads N      Threads do torneio (padrao 0 = uma por nucleo)\n"
+           "  --schedule S     Agenda do torneio: random (padrao; fitness = pontos), round-robin ou swiss\n"
+           "                   (fitness = rating Elo), ou racing (partidas rasas para todos; mais partidas e\n"
+           "                   mais fundas so para os candidatos a pais e a elite)\n"
+           "  --matches N      Partidas por agente (random), rodadas (swiss) ou partidas por etapa (racing)\n"
+           "                   por geracao (padrao 3)\n"
+           "  --adjudicate N   Encerra a partida pelo solver exato com N casas vazias ou menos (ate %d)\n"
+           "                   (padrao 0 = desligado; as partidas param em 30 jogadas, entao use N > 12; so 6x7)\n"
+           "  --board B        Tabuleiro das partidas de treino: 6x7 (padrao), 5x6 ou 7x8\n"
+           "  --out ARQUIVO    Onde gravar o genoma campeao (padrao champion.txt)\n"
+           "  --checkpoint ARQUIVO  Grava checkpoints do treino neste arquivo\n"
+           "  --checkpoint-every N  Geracoes entre checkpoints (padrao 1)\n"
+           "  --resume ARQUIVO      Continua o treino de um checkpoint (ate o total de --generations)\n"
+           "  --islands N      Modelo de ilhas: N processos, cada um com a sua populacao de --population\n"
+           "                   agentes (padrao 0 = desligado; nao combina com checkpoints)\n"
+           "  --migrate-every K  Geracoes entre migracoes entre ilhas (padrao 5)\n"
+           "  --migrants M     Melhores de cada ilha enviados a vizinha em cada migracao (padrao 2)\n"
+           "  --stats ARQUIVO  Grava os contadores de cada geracao (nos, podas, folhas, tempo das partidas,\n"
+           "                   da selecao e da reproducao) em CSV (.csv) ou JSON\n"
+           "  --games ARQUIVO  Grava todas as partidas do treino neste log (3 bits por jogada; com --resume,\n"
+           "                   continua o log existente). Leia com o connect4-games\n",
+           POPULATION_SIZE, MUTATION_RATE, MAX_ADJUDICATE_EMPTY);
+}
+
+// O Solver só conhece o tabuleiro 6x7: nos outros, --adjudicate não teria efeito
+static bool AdjudicateSupported() {
+    if (evoConfig.adjudicateEmpty == 0 || evoConfig.board == BOARD_6X7) return true;
+    fprintf(stderr, "--adjudicate so funciona no tabuleiro 6x7\n");
+    return false;
+}
+
+static void PrintIslandReport(const IslandReport& r) {
+    printf("Ilha %d, geracao %d: fitness %.0f  genoma [%.3f %.3f %.3f %.3f]  (%lld partidas)\n", r.island, r.generation,
+           r.fitness, r.champion[0], r.champion[1], r.champion[2], r.champion[3], r.games);
+    fflush(stdout);
+}
+
+static bool WriteChampion(const char* outPath, const Agent& champion) {
+    // Genoma campeão: um gene por linha, com precisão total
+    FILE* f = fopen(outPath, "w");
+    if (!f) { fprintf(stderr, "Nao foi possivel gravar %s\n", outPath); return false; }
+    for (double g : champion.genome) fprintf(f, "%.17g\n", g);
+    fclose(f);
+    printf("Campeao gravado em %s\n", outPath);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int generations = 50;
+    uint32_t seed = random_device()();
+    const char* outPath = "champion.txt";
+    const char* checkpointPath = nullptr;
+    const char* resumePath = nullptr;
+    const char* statsPath = nullptr;
+    const char* gamesPath = nullptr;
+    int checkpointEvery = 1;
+    IslandConfig islands;
+    islands.islands = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) { PrintUsage(); return 0; }
+        else if (!strcmp(arg, "--population") && hasValue) evoConfig.populationSize = atoi(argv[++i]);
+        else if (!strcmp(arg, "--generations") && hasValue) generations = atoi(argv[++i]);
+        else if (!strcmp(arg, "--depth") && hasValue) evoConfig.trainingDepth = atoi(argv[++i]);
+        else if (!strcmp(arg, "--mutation") && hasValue) evoConfig.mutationRate = atof(argv[++i]);
+        else if (!strcmp(arg, "--seed") && hasValue) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(arg, "--threads") && hasValue) evoConfig.threads = atoi(argv[++i]);
+        else if (!strcmp(arg, "--schedule") && hasValue) {
+            if (!ParseSchedule(argv[++i], evoConfig.schedule)) { fprintf(stderr, "Agenda invalida: %s\n", argv[i]); return 1; }
+        }
+        else if (!strcmp(arg, "--matches") && hasValue) evoConfig.matchesPerAgent = atoi(argv[++i]);
+        else if (!strcmp(arg, "--adjudicate") && hasValue) evoConfig.adjudicateEmpty = atoi(argv[++i]);
+        else if (!strcmp(arg, "--board") && hasValue) {
+            if (!ParseBoardVariant(argv[++i], evoConfig.board)) { fprintf(stderr, "Tabuleiro invalido: %s\n", argv[i]); return 1; }
+        }
+        else if (!strcmp(arg, "--out") && hasValue) outPath = argv[++i];
+        else if (!strcmp(arg, "--checkpoint") && hasValue) checkpointPath = argv[++i];
+        else if (!strcmp(arg, "--checkpoint-every") && hasValue) checkpointEvery = atoi(argv[++i]);
+        else if (!strcmp(arg, "--resume") && hasValue) resumePath = argv[++i];
+        else if (!strcmp(arg, "--islands") && hasValue) islands.islands = atoi(argv[++i]);
+        else if (!strcmp(arg, "--migrate-every") && hasValue) islands.migrateEvery = atoi(argv[++i]);
+        else if (!strcmp(arg, "--migrants") && hasValue) islands.migrants = atoi(argv[++i]);
+        else if (!strcmp(arg, "--stats") && hasValue) statsPath = argv[++i];
+        else if (!strcmp(arg, "--games") && hasValue) gamesPath = argv[++i];
+        else { fprintf(stderr, "Argumento invalido: %s\n", arg); PrintUsage(); return 1; }
+    }
+    if (evoConfig.populationSize < 2 || generations < 1 || evoConfig.trainingDepth < 1 || checkpointEvery < 1 ||
+        evoConfig.matchesPerAgent < 1 || evoConfig.mutationRate < 0 || evoConfig.mutationRate > 1 ||
+        evoConfig.threads < 0 || evoConfig.adjudicateEmpty < 0 || evoConfig.adjudicateEmpty > MAX_ADJUDICATE_EMPTY) {
+        fprintf(stderr, "Parametros invalidos\n");
+        return 1;
+    }
+    if (!AdjudicateSupported()) return 1;
+
+    if (islands.islands > 0) {
+        if (checkpointPath || resumePath || statsPath || gamesPath || islands.migrateEvery < 1 || islands.migrants < 0) {
+            fprintf(stderr, "Parametros invalidos para o modelo de ilhas (sem --checkpoint/--resume/--stats/--games)\n");
+            return 1;
+        }
+        islands.generations = generations;
+        islands.seed = seed;
+        printf("Treinando em %d ilhas: populacao %d por ilha, %d geracoes, migracao de %d a cada %d geracoes, "
+               "depth %d, mutacao %.2f, torneio %s, tabuleiro %s, semente %u\n", islands.islands, evoConfig.populationSize,
+               generations, islands.migrants, islands.migrateEvery, evoConfig.trainingDepth, evoConfig.mutationRate,
+               ScheduleName(evoConfig.schedule), BoardVariantName(evoConfig.board), seed);
+        auto start = chrono::steady_clock::now();
+        IslandResult result;
+        if (!RunIslands(islands, PrintIslandReport, result)) { fprintf(stderr, "O treino em ilhas falhou\n"); return 1; }
+        double total = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("Concluido em %.1f s (%lld partidas jogadas, %lld reaproveitadas do cache); campeao global da ilha %d\n",
+               total, result.games, result.cached, result.championIsland);
+        return WriteChampion(outPath, result.champion) ? 0 : 1;
+    }
+
+    // O checkpoint traz população, parâmetros e gerador; --generations vira o total a atingir
+    CheckpointExtras extras;
+    if (resumePath) {
+        if (!LoadCheckpoint(resumePath, extras)) { fprintf(stderr, "Checkpoint invalido: %s\n", resumePath); return 1; }
+        printf("Continuando de %s: geracao %d, populacao %d, depth %d, mutacao %.2f, torneio %s, tabuleiro %s\n",
+               resumePath, globalGenCounter, evoConfig.populationSize, evoConfig.trainingDepth, evoConfig.mutationRate,
+               ScheduleName(evoConfig.schedule), BoardVariantName(evoConfig.board));
+    }
+    if (!AdjudicateSupported()) return 1; // O tabuleiro pode ter vindo do checkpoint
+    // Jogadores e campeão vão para o log como índices u16 (a população também pode vir do checkpoint)
+    if (gamesPath && evoConfig.populationSize > GAME_LOG_MAX_POPULATION) {
+        fprintf(stderr, "--games aceita populacoes de ate %d agentes\n", GAME_LOG_MAX_POPULATION);
+        return 1;
+    }
+    if (!resumePath) {
+        printf("Treinando: populacao %d, %d geracoes, depth %d, mutacao %.2f, torneio %s, tabuleiro %s, semente %u\n",
+               evoConfig.populationSize, generations, evoConfig.trainingDepth, evoConfig.mutationRate,
+               ScheduleName(evoConfig.schedule), BoardVariantName(evoConfig.board), seed);
+        SeedEvolution(seed);
+        InitPopulation();
+    }
+
+    GameLog games;
+    if (gamesPath) {
+        if (!games.open(gamesPath, resumePath != nullptr)) { fprintf(stderr, "Nao foi possivel abrir o log %s\n", gamesPath); return 1; }
+        trainingLog = &games;
+    }
+
+    Agent champion(extras.best);
+    champion.fitness = extras.bestFitness;
+    StatTrace trace;
+    trace.start();
+    auto start = chrono::steady_clock::now();
+    while (globalGenCounter < generations) {
+        auto t0 = chrono::steady_clock::now();
+        champion = EvolveOneGeneration();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        printf("Geracao %d: fitness %.0f  genoma [%.3f %.3f %.3f %.3f]  (%.0f ms)\n", globalGenCounter, champion.fitness,
+               champion.genome[0], champion.genome[1], champion.genome[2], champion.genome[3], ms);
+        if (statsPath) trace.sample("generation", globalGenCounter);
+        fflush(stdout);
+        if (checkpointPath && (globalGenCounter % checkpointEvery == 0 || globalGenCounter == generations)) {
+            extras.hasBest = true; extras.best = champion.genome; extras.bestFitness = champion.fitness;
+            if (!SaveCheckpoint(checkpointPath, extras)) fprintf(stderr, "Nao foi possivel gravar o checkpoint %s\n", checkpointPath);
+        }
+    }
+    double total = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("Concluido em %.1f s (%lld partidas jogadas, %lld reaproveitadas do cache)\n", total,
+           tournamentStats.games, tournamentStats.cached);
+#if C4_STATS
+    StatSnapshot st;
+    CollectStats(st);
+    printf("Tempo nas geracoes: partidas %.0f ms, selecao %.1f ms, reproducao %.1f ms; %.1f milhoes de nos, "
+           "%.1f%% com poda, %.1f milhoes de folhas\n", st.ms(TIMER_MATCHES), st.ms(TIMER_SELECTION),
+           st.ms(TIMER_REPRODUCTION), st.count[STAT_NODES] / 1e6,
+           st.count[STAT_NODES] ? 100.0 * st.count[STAT_CUTOFFS] / st.count[STAT_NODES] : 0.0, st.count[STAT_LEAF_EVALS] / 1e6);
+#endif
+    if (statsPath) {
+        if (trace.write(statsPath)) printf("Contadores gravados em %s\n", statsPath);
+        else fprintf(stderr, "Nao foi possivel gravar %s\n", statsPath);
+    }
+    if (gamesPath) {
+        // Se uma gravação falhou no meio do treino, o log foi fechado no último bloco completo
+        if (games.isOpen()) printf("%lld partidas gravadas em %s\n", games.games(), gamesPath);
+        else fprintf(stderr, "Nao foi possivel gravar todas as partidas em %s\n", gamesPath);
+        trainingLog = nullptr;
+    }
+    return WriteChampion(outPath, champion) ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#include "TranspositionTable.h"
+#include <cstring>
+
+using namespace std;
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t n = 1;
+    while ((n * 2) * sizeof(TTBucket) <= megabytes * 1024 * 1024) n *= 2;
+    buckets.reset(new TTBucket[n]);
+    mask = n - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; i++) for (TTSlot& e : buckets[i].e) { e.lock.store(0, memory_order_relaxed); e.data.store(0, memory_order_relaxed); }
+    hits = misses = collisions = stores = 0;
+    age = 0;
+}
+
+uint64_t GenomeHash(const double* genome, int count) {
+    uint64_t h = 0x6A09E667F3BCC909ULL;
+    for (int i = 0; i < count; i++) {
+        uint64_t bits; memcpy(&bits, &genome[i], sizeof(bits));
+        h = (h ^ bits) * 0x100000001B3ULL;
+    }
+    return h;
+}
+
+void TranspositionTable::bindGenome(const double* genome, int count) {
+    uint64_t h = GenomeHash(genome, count);
+    if (h != genomeKey) { clear(); genomeKey = h; }
+}
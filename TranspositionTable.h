@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+// Tabela de Transposição
+// Guarda resultados de posições já analisadas pelo Minimax, para que a mesma posição
+// alcançada por ordens diferentes de jogadas não seja recalculada.
+// Pode ser compartilhada por várias threads (Lazy SMP) sem locks: ver TTSlot.
+enum BoundType : uint8_t {
+    BOUND_NONE = 0,  // Entrada vazia
+    BOUND_EXACT,     // Valor exato
+    BOUND_LOWER,     // Houve poda: o valor real é >= score
+    BOUND_UPPER      // Nenhuma jogada superou alpha: o valor real é <= score
+};
+
+// Conteúdo de uma entrada (como probe() a devolve)
+struct TTEntry {
+    uint32_t check;  // 32 bits altos da chave, para confirmar que é a mesma posição
+    int8_t depth;    // Profundidade restante com que a posição foi analisada
+    uint8_t bound;   // BoundType
+    int8_t col;      // Melhor coluna encontrada (-1 se nenhuma)
+    uint8_t age;     // Busca em que a entrada foi gravada (para a política de substituição)
+    double score;
+};
+
+// Entrada na memória: 16 bytes, 4 por bucket = 1 linha de cache (64 bytes).
+// Os campos de TTEntry (menos o score) cabem em 64 bits ("meta"). Cada palavra é gravada
+// atomicamente, mas duas threads podem intercalar as gravações; por isso a primeira palavra
+// guarda meta XOR score: uma entrada misturada decodifica um check errado e é ignorada.
+struct TTSlot {
+    std::atomic<uint64_t> lock{ 0 };  // meta ^ bits do score
+    std::atomic<uint64_t> data{ 0 };  // bits do score
+
+    static uint64_t pack(const TTEntry& e) {
+        return (uint64_t)e.check << 32 | (uint64_t)(uint8_t)e.depth << 24 | (uint64_t)e.bound << 16 |
+               (uint64_t)(uint8_t)e.col << 8 | e.age;
+    }
+    TTEntry load() const {
+        uint64_t d = data.load(std::memory_order_relaxed);
+        uint64_t meta = lock.load(std::memory_order_relaxed) ^ d;
+        TTEntry e;
+        e.check = (uint32_t)(meta >> 32); e.depth = (int8_t)(meta >> 24); e.bound = (uint8_t)(meta >> 16);
+        e.col = (int8_t)(meta >> 8); e.age = (uint8_t)meta;
+        memcpy(&e.score, &d, sizeof(d));
+        return e;
+    }
+    void save(const TTEntry& e) {
+        uint64_t d; memcpy(&d, &e.score, sizeof(d));
+        lock.store(pack(e) ^ d, std::memory_order_relaxed);
+        data.store(d, std::memory_order_relaxed);
+    }
+};
+const int TT_BUCKET_SIZE = 4;
+struct alignas(64) TTBucket { TTSlot e[TT_BUCKET_SIZE]; };
+
+// Identificador de um genoma (hash dos bits dos genes): diz se dados gravados para
+// um genoma (tabela de transposição, livro de aberturas) valem para outro
+uint64_t GenomeHash(const double* genome, int count);
+
+class TranspositionTable {
+public:
+    // Contadores para medir a redução de nós (aproximados quando há várias threads)
+    std::atomic<uint64_t> hits{ 0 }, misses{ 0 }, collisions{ 0 }, stores{ 0 };
+
+    explicit TranspositionTable(size_t megabytes = 64) { resize(megabytes); }
+
+    // Ajusta o orçamento de memória (arredondado para baixo para uma potência de 2 de buckets)
+    void resize(size_t megabytes);
+
+    void clear();
+
+    // Os scores dependem dos pesos do genoma, então a tabela só vale para um genoma (ver GenomeHash).
+    // Trocar de genoma limpa a tabela.
+    void bindGenome(const double* genome, int count);
+
+    // Marca o início de uma nova busca (entradas antigas passam a ser substituídas primeiro)
+    void newSearch() { age++; }
+
+    size_t sizeInBytes() const { return (mask + 1) * sizeof(TTBucket); }
+
+    bool probe(uint64_t key, TTEntry& out) {
+        TTBucket& b = buckets[key & mask];
+        uint32_t check = (uint32_t)(key >> 32);
+        for (TTSlot& slot : b.e) {
+            TTEntry e = slot.load();
+            if (e.bound != BOUND_NONE && e.check == check) { out = e; bump(hits); return true; }
+        }
+        bump(misses);
+        return false;
+    }
+
+    // Política de substituição: reaproveita a entrada da mesma posição; senão ocupa uma
+    // vazia; senão substitui a de busca mais antiga e, em empate, a de menor profundidade.
+    void store(uint64_t key, int depth, BoundType bound, double score, int col) {
+        TTBucket& b = buckets[key & mask];
+        uint32_t check = (uint32_t)(key >> 32);
+        TTSlot* victim = &b.e[0];
+        TTEntry v = victim->load();
+        for (TTSlot& slot : b.e) {
+            TTEntry e = slot.load();
+            if (e.bound == BOUND_NONE || e.check == check) { victim = &slot; v = e; break; }
+            bool older = e.age != age && v.age == age;
+            bool sameAge = (e.age == age) == (v.age == age);
+            if (older || (sameAge && e.depth < v.depth)) { victim = &slot; v = e; }
+        }
+        if (v.bound != BOUND_NONE && v.check != check) bump(collisions);
+        victim->save(TTEntry{ check, (int8_t)depth, (uint8_t)bound, (int8_t)col, age, score });
+        bump(stores);
+    }
+
+private:
+    std::unique_ptr<TTBucket[]> buckets;
+    size_t mask = 0;
+    uint8_t age = 0;
+    uint64_t genomeKey = 0;
+
+    // Incremento sem instrução atômica de leitura-escrita (barato; pode perder contagens entre threads)
+    static void bump(std::atomic<uint64_t>& c) { c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+};